@@ -0,0 +1,117 @@
+// Time per frame of every anti-aliasing mode (off, msaa2, msaa4, msaa8, fxaa) for a game frame rendered through
+// PostProcessor: background, level and a batch of rotated sprites. Frames are timed with GL_TIME_ELAPSED queries
+// and by the wall clock with glFinish; the query column reads n/a where the driver has no timer.
+// Usage: anti_aliasing_bench [frames]
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include "GLBench.h"
+#include "FrameData.h"
+#include "GameLevel.h"
+#include "PostProcessor.h"
+#include "ResourceManager.h"
+#include "SpriteBatch.h"
+#include "SpriteRenderer.h"
+
+
+const unsigned int SCREEN_WIDTH = 800;
+const unsigned int SCREEN_HEIGHT = 600;
+const unsigned int ROTATED_SPRITES = 200;
+
+// renders frames frames in every mode and prints the table
+static void run(unsigned int frames)
+{
+    ResourceManager::LoadShader("resources/shaders/Game/sprite.vs", "resources/shaders/Game/sprite.frag", nullptr,
+                                "sprite");
+    ResourceManager::LoadShader("resources/shaders/Game/sprite_unrotated.vs", "resources/shaders/Game/sprite.frag",
+                                nullptr, "sprite_unrotated");
+    ResourceManager::LoadShader("resources/shaders/Game/post_processing.vs",
+                                "resources/shaders/Game/post_processing.frag", nullptr, "postprocessing");
+    ResourceManager::LoadShader("resources/shaders/Game/post_processing.vs", "resources/shaders/Game/post_chain.frag",
+                                nullptr, "postchain");
+    FrameData frame;
+    frame.Projection = glm::ortho(0.0f, static_cast<float>(SCREEN_WIDTH), static_cast<float>(SCREEN_HEIGHT), 0.0f,
+                                  -1.0f, 1.0f);
+    frame.ViewportSize = glm::vec2(SCREEN_WIDTH, SCREEN_HEIGHT);
+    frame.Time = 0.0f;
+    frame.Upload();
+    ResourceManager::GetShader("sprite").Use().SetInteger("image", 0);
+    ResourceManager::GetShader("sprite_unrotated").Use().SetInteger("image", 0);
+    ResourceManager::AddToAtlas("resources/textures/background.jpg", false, "background");
+    ResourceManager::AddToAtlas("resources/textures/awesomeface.png", true, "face");
+    ResourceManager::AddToAtlas("resources/textures/block.png", false, "block");
+    ResourceManager::AddToAtlas("resources/textures/block_solid.png", false, "block_solid");
+    ResourceManager::BuildAtlas();
+    GameLevel level;
+    level.Load("resources/levels/level1.lvl", SCREEN_WIDTH, SCREEN_HEIGHT / 2);
+    SpriteRenderer renderer(ResourceManager::GetShader("sprite"), ResourceManager::GetShader("sprite_unrotated"));
+    SpriteBatch batch(ResourceManager::GetShader("sprite"), ResourceManager::GetShader("sprite_unrotated"));
+    PostProcessor effects("postprocessing", "postchain", SCREEN_WIDTH, SCREEN_HEIGHT);
+
+    // the scene of Game::renderScene without the queue, plus rotated sprites whose edges the modes smooth
+    auto renderFrame = [&]()
+    {
+        glClear(GL_COLOR_BUFFER_BIT);
+        effects.BeginRender();
+        renderer.DrawSprite(ResourceManager::GetTexture("background"), glm::vec2(0.0f),
+                            glm::vec2(SCREEN_WIDTH, SCREEN_HEIGHT));
+        level.Draw(batch);
+        batch.Begin();
+        for (unsigned int i = 0; i < ROTATED_SPRITES; ++i)
+            batch.Submit(ResourceManager::GetTexture("face"),
+                         glm::vec2((i * 97) % (SCREEN_WIDTH - 40), SCREEN_HEIGHT / 2 + (i * 53) % (SCREEN_HEIGHT / 2 - 40)),
+                         glm::vec2(40.0f), i * 7.0f);
+        batch.Flush();
+        effects.EndRender();
+        effects.Render();
+    };
+
+    GLint timerBits = 0;
+    glGetQueryiv(GL_TIME_ELAPSED, GL_QUERY_COUNTER_BITS, &timerBits);
+    std::vector<unsigned int> queries(frames);
+    glGenQueries(frames, queries.data());
+    std::printf("%u frames per mode\n%-6s %8s %10s %10s\n", frames, "mode", "samples", "gpu ms", "wall ms");
+    for (int mode = 0; mode < AA_MODES; ++mode)
+    {
+        effects.SetAntiAliasing(static_cast<AntiAliasing>(mode));
+        // GPU time of every frame on its own, read back once all are done
+        renderFrame();
+        for (unsigned int i = 0; i < frames; ++i)
+        {
+            glBeginQuery(GL_TIME_ELAPSED, queries[i]);
+            renderFrame();
+            glEndQuery(GL_TIME_ELAPSED);
+        }
+        double gpuTime = 0.0;
+        for (unsigned int query : queries)
+        {
+            GLuint64 elapsed = 0;
+            glGetQueryObjectui64v(query, GL_QUERY_RESULT, &elapsed);
+            gpuTime += elapsed * 1.0e-6;
+        }
+        double wallTime = TimeFrames(renderFrame, frames);
+        if (timerBits > 0)
+            std::printf("%-6s %8u %10.3f %10.3f\n", PostProcessor::AntiAliasingName(static_cast<AntiAliasing>(mode)),
+                        effects.Samples, gpuTime / frames, wallTime);
+        else
+            std::printf("%-6s %8u %10s %10.3f\n", PostProcessor::AntiAliasingName(static_cast<AntiAliasing>(mode)),
+                        effects.Samples, "n/a", wallTime);
+    }
+    glDeleteQueries(frames, queries.data());
+}
+
+int main(int argc, char *argv[])
+{
+    unsigned int frames = argc > 1 ? static_cast<unsigned int>(std::strtoul(argv[1], nullptr, 10)) : 60;
+    GLFWwindow *window = CreateBenchWindow(SCREEN_WIDTH, SCREEN_HEIGHT);
+    if (!window)
+        return -1;
+    run(std::max(frames, 1u));
+    ResourceManager::Clear();
+    glfwTerminate();
+    return 0;
+}
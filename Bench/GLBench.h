@@ -0,0 +1,72 @@
+#ifndef PROJEKT1_GLBENCH_H
+#define PROJEKT1_GLBENCH_H
+
+#include <chrono>
+#include <cstdio>
+
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+
+#include "GLStateCache.h"
+
+
+// Shared by the rendering benchmarks: a hidden window with the game's
+// context and blend state, and a frame timer that waits for the GPU
+// (glFinish) so a frame counts everything the driver deferred.
+// Shaders and textures load from resources/, so run them from the
+// build directory like the game.
+
+// creates a hidden window of the given size with the game's GL 3.3 core context; nullptr if that fails
+inline GLFWwindow *CreateBenchWindow(unsigned int width, unsigned int height)
+{
+    if (!glfwInit())
+    {
+        std::printf("ERROR::BENCH: Failed to initialize GLFW\n");
+        return nullptr;
+    }
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+#ifdef __APPLE__
+    glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
+#endif
+    glfwWindowHint(GLFW_RESIZABLE, false);
+    glfwWindowHint(GLFW_VISIBLE, false);
+    GLFWwindow *window = glfwCreateWindow(width, height, "Benchmark", nullptr, nullptr);
+    if (!window)
+    {
+        std::printf("ERROR::BENCH: Failed to create a GL 3.3 context\n");
+        glfwTerminate();
+        return nullptr;
+    }
+    glfwMakeContextCurrent(window);
+    if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress))
+    {
+        std::printf("ERROR::BENCH: Failed to initialize GLAD\n");
+        glfwTerminate();
+        return nullptr;
+    }
+    // no vsync, frames are timed back to back
+    glfwSwapInterval(0);
+    glViewport(0, 0, width, height);
+    GLStateCache::SetBlend(true);
+    GLStateCache::BlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA); // premultiplied alpha, as in the game
+    std::printf("%s / %s\n", glGetString(GL_RENDERER), glGetString(GL_VERSION));
+    return window;
+}
+
+// milliseconds one call of frame takes including the GPU work it queued, averaged over frames calls
+template <typename Frame>
+double TimeFrames(Frame frame, unsigned int frames)
+{
+    frame(); // warm up shaders and buffers
+    glFinish();
+    auto start = std::chrono::steady_clock::now();
+    for (unsigned int i = 0; i < frames; ++i)
+        frame();
+    glFinish();
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() / frames;
+}
+
+
+#endif //PROJEKT1_GLBENCH_H
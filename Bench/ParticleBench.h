@@ -0,0 +1,55 @@
+#ifndef PROJEKT1_PARTICLEBENCH_H
+#define PROJEKT1_PARTICLEBENCH_H
+
+#include <algorithm>
+#include <chrono>
+
+#include "ParticleKernels.h"
+#include "Random.h"
+
+
+// Shared by the particle update benchmarks: a pool of count live
+// particles that stays alive for the whole run, and a timer that
+// reports the best of a few repetitions to keep scheduling noise out.
+
+// fills particles with count live particles of random position, velocity and color
+inline void FillParticles(ParticleStreams &particles, unsigned int count)
+{
+    Rng rng(1);
+    particles.Resize(count);
+    for (unsigned int i = 0; i < count; ++i)
+    {
+        particles.PositionX[i] = rng.Range(0.0f, 800.0f);
+        particles.PositionY[i] = rng.Range(0.0f, 600.0f);
+        particles.VelocityX[i] = rng.Range(-100.0f, 100.0f);
+        particles.VelocityY[i] = rng.Range(-350.0f, 350.0f);
+        // long enough to survive every update of the run
+        particles.Life[i] = 1.0e6f;
+    }
+}
+
+// microseconds one call of update takes, best of repetitions runs of iterations calls each
+template <typename Update>
+double TimeUpdate(Update update, unsigned int iterations, unsigned int repetitions = 5)
+{
+    double best = 1.0e30;
+    update(); // warm up caches and threads
+    for (unsigned int r = 0; r < repetitions; ++r)
+    {
+        auto start = std::chrono::steady_clock::now();
+        for (unsigned int i = 0; i < iterations; ++i)
+            update();
+        double elapsed = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+        best = std::min(best, elapsed / iterations);
+    }
+    return best;
+}
+
+// updates per measurement for a pool of count particles, about 16M particle updates each
+inline unsigned int BenchIterations(unsigned int count)
+{
+    return std::max(1u, (16u << 20) / count);
+}
+
+
+#endif //PROJEKT1_PARTICLEBENCH_H
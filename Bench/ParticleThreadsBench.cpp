@@ -0,0 +1,53 @@
+// Speedup of UpdateParticlesParallel over 1-16 threads for pools of 64K to 4M
+// particles. Usage: particle_threads_bench [max threads]
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+
+#include "ParticleBench.h"
+#include "ThreadPool.h"
+
+
+int main(int argc, char *argv[])
+{
+    unsigned int maxThreads = argc > 1 ? static_cast<unsigned int>(std::strtoul(argv[1], nullptr, 10)) : 16;
+    maxThreads = std::max(maxThreads, 1u);
+    const unsigned int counts[] = { 1u << 16, 1u << 18, 1u << 20, 1u << 22 };
+    std::printf("kernel %s, %u hardware threads, us per update (speedup over 1 thread)\n", ParticleKernelName(),
+                std::thread::hardware_concurrency());
+    std::printf("threads");
+    for (unsigned int count : counts)
+        std::printf(" %20u", count);
+    std::printf("\n");
+    // single-threaded baseline: the kernel called directly, without the pool
+    ParticleStreams particles[4];
+    double baseline[4];
+    std::printf("%7s", "none");
+    for (unsigned int c = 0; c < 4; ++c)
+    {
+        FillParticles(particles[c], counts[c]);
+        ParticleStreams &pool = particles[c];
+        unsigned int count = counts[c];
+        baseline[c] = TimeUpdate([&pool, count]() { UpdateParticles(pool, 0, count, 0.0001f); },
+                                 BenchIterations(count));
+        std::printf(" %12.1f        ", baseline[c]);
+    }
+    std::printf("\n");
+    for (unsigned int threads = 1; threads <= maxThreads; ++threads)
+    {
+        ThreadPool workers(threads - 1);
+        std::printf("%7u", threads);
+        for (unsigned int c = 0; c < 4; ++c)
+        {
+            ParticleStreams &pool = particles[c];
+            unsigned int count = counts[c];
+            double time = TimeUpdate([&pool, count, &workers]()
+            {
+                UpdateParticlesParallel(pool, 0, count, 0.0001f, workers);
+            }, BenchIterations(count));
+            std::printf(" %12.1f (%5.2fx)", time, baseline[c] / time);
+        }
+        std::printf("\n");
+    }
+    return 0;
+}
@@ -0,0 +1,122 @@
+// Draw calls and time per frame of a 100x100 (10k brick) level rendered one DrawSprite call per brick,
+// through SpriteBatch::Submit/Flush, and from the level's retained brick mesh (what the game draws with).
+// Usage: sprite_batch_bench [frames]
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <vector>
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include "GLBench.h"
+#include "FrameData.h"
+#include "GameLevel.h"
+#include "ResourceManager.h"
+#include "SpriteBatch.h"
+#include "SpriteRenderer.h"
+
+
+const unsigned int SCREEN_WIDTH = 800;
+const unsigned int SCREEN_HEIGHT = 600;
+const unsigned int LEVEL_TILES = 100; // per side
+const char *LEVEL_FILE = "sprite_batch_bench.lvl";
+
+// the frame in the window's back buffer
+static std::vector<unsigned char> readFrame()
+{
+    std::vector<unsigned char> pixels(SCREEN_WIDTH * SCREEN_HEIGHT * 4);
+    glReadPixels(0, 0, SCREEN_WIDTH, SCREEN_HEIGHT, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+    return pixels;
+}
+
+// largest difference of any channel between two frames
+static int maxDifference(const std::vector<unsigned char> &a, const std::vector<unsigned char> &b)
+{
+    int difference = 0;
+    for (size_t i = 0; i < a.size(); ++i)
+        difference = std::max(difference, std::abs(a[i] - b[i]));
+    return difference;
+}
+
+// renders the level through every path, frames times each
+static void run(unsigned int frames)
+{
+    // the game's sprite shaders and atlas
+    ResourceManager::LoadShader("resources/shaders/Game/sprite.vs", "resources/shaders/Game/sprite.frag", nullptr,
+                                "sprite");
+    ResourceManager::LoadShader("resources/shaders/Game/sprite_unrotated.vs", "resources/shaders/Game/sprite.frag",
+                                nullptr, "sprite_unrotated");
+    FrameData frame;
+    frame.Projection = glm::ortho(0.0f, static_cast<float>(SCREEN_WIDTH), static_cast<float>(SCREEN_HEIGHT), 0.0f,
+                                  -1.0f, 1.0f);
+    frame.ViewportSize = glm::vec2(SCREEN_WIDTH, SCREEN_HEIGHT);
+    frame.Upload();
+    ResourceManager::GetShader("sprite").Use().SetInteger("image", 0);
+    ResourceManager::GetShader("sprite_unrotated").Use().SetInteger("image", 0);
+    ResourceManager::AddToAtlas("resources/textures/block.png", false, "block");
+    ResourceManager::AddToAtlas("resources/textures/block_solid.png", false, "block_solid");
+    ResourceManager::BuildAtlas();
+    // a level of every tile code (solid and the four colors) filling the upper half of the screen like the game's
+    {
+        std::ofstream file(LEVEL_FILE);
+        for (unsigned int y = 0; y < LEVEL_TILES; ++y)
+        {
+            for (unsigned int x = 0; x < LEVEL_TILES; ++x)
+                file << 1 + (x + y) % 5 << ' ';
+            file << '\n';
+        }
+    }
+    GameLevel level;
+    level.Load(LEVEL_FILE, SCREEN_WIDTH, SCREEN_HEIGHT / 2);
+    std::remove(LEVEL_FILE);
+    SpriteRenderer renderer(ResourceManager::GetShader("sprite"), ResourceManager::GetShader("sprite_unrotated"));
+    SpriteBatch batch(ResourceManager::GetShader("sprite"), ResourceManager::GetShader("sprite_unrotated"));
+
+    std::printf("%zu bricks, %u frames\n%-14s %8s %10s %s\n", level.Bricks.size(), frames, "path", "draws",
+                "ms/frame", "max diff");
+    // one draw call per brick
+    auto drawSprites = [&]()
+    {
+        glClear(GL_COLOR_BUFFER_BIT);
+        level.Draw(renderer);
+    };
+    double time = TimeFrames(drawSprites, frames);
+    std::vector<unsigned char> reference = readFrame();
+    std::printf("%-14s %8zu %10.2f %d\n", "DrawSprite", level.Bricks.size(), time, 0);
+    // every brick submitted to the batch each frame
+    auto submitBatch = [&]()
+    {
+        glClear(GL_COLOR_BUFFER_BIT);
+        batch.Begin();
+        for (GameObject &brick : level.Bricks)
+            brick.Draw(batch);
+        batch.Flush();
+    };
+    time = TimeFrames(submitBatch, frames);
+    batch.ResetStats();
+    submitBatch();
+    std::printf("%-14s %8u %10.2f %d\n", "SpriteBatch", batch.DrawCalls, time, maxDifference(reference, readFrame()));
+    // the level's brick mesh, uploaded once and drawn with the batch's shader
+    auto retainedMesh = [&]()
+    {
+        glClear(GL_COLOR_BUFFER_BIT);
+        level.Draw(batch);
+    };
+    time = TimeFrames(retainedMesh, frames);
+    batch.ResetStats();
+    retainedMesh();
+    std::printf("%-14s %8u %10.2f %d\n", "level mesh", batch.DrawCalls, time, maxDifference(reference, readFrame()));
+}
+
+int main(int argc, char *argv[])
+{
+    unsigned int frames = argc > 1 ? static_cast<unsigned int>(std::strtoul(argv[1], nullptr, 10)) : 20;
+    GLFWwindow *window = CreateBenchWindow(SCREEN_WIDTH, SCREEN_HEIGHT);
+    if (!window)
+        return -1;
+    run(std::max(frames, 1u));
+    ResourceManager::Clear();
+    glfwTerminate();
+    return 0;
+}
@@ -0,0 +1,231 @@
+// CPU cost of 100k DrawSprite calls: the old path, which composes a model matrix from four glm::mat4 products and
+// uploads it with the color and UV rect as three uniforms per sprite, against the current SpriteRenderer, which
+// passes the sprite as constant vertex attributes 1-4 and lets sprite.vs/sprite_unrotated.vs build the quad.
+// Usage: sprite_renderer_bench [frames]
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include "GLBench.h"
+#include "FrameData.h"
+#include "ResourceManager.h"
+#include "SpriteRenderer.h"
+
+
+const unsigned int SCREEN_WIDTH = 800;
+const unsigned int SCREEN_HEIGHT = 600;
+const unsigned int SPRITES = 100000;
+
+// sprite.vs and sprite.frag as they were before the constant attributes
+const char *MATRIX_VERTEX_SOURCE = R"(#version 330 core
+layout (location = 0) in vec4 vertex; // <vec2 position, vec2 texCoords>
+
+out vec2 TexCoords;
+
+uniform mat4 model;
+uniform mat4 projection;
+uniform vec4 uvRect; // <vec2 min, vec2 max> texture region, e.g. inside an atlas
+
+void main()
+{
+    TexCoords = mix(uvRect.xy, uvRect.zw, vertex.zw);
+    gl_Position = projection * model * vec4(vertex.xy, 0.0, 1.0);
+}
+)";
+const char *MATRIX_FRAGMENT_SOURCE = R"(#version 330 core
+in vec2 TexCoords;
+out vec4 color;
+
+uniform sampler2D image;
+uniform vec3 spriteColor;
+
+void main()
+{
+    color = vec4(spriteColor, 1.0) * texture(image, TexCoords);
+}
+)";
+
+struct Sprite
+{
+    glm::vec2 Position, Size;
+    float     Rotation;
+    glm::vec3 Color;
+};
+
+// model matrix of a sprite as the old DrawSprite composed it: scale, rotate around the center, translate
+static glm::mat4 spriteModel(glm::vec2 position, glm::vec2 size, float rotate)
+{
+    glm::mat4 model = glm::mat4(1.0f);
+    model = glm::translate(model, glm::vec3(position, 0.0f));
+    model = glm::translate(model, glm::vec3(0.5f * size.x, 0.5f * size.y, 0.0f));
+    model = glm::rotate(model, glm::radians(rotate), glm::vec3(0.0f, 0.0f, 1.0f));
+    model = glm::translate(model, glm::vec3(-0.5f * size.x, -0.5f * size.y, 0.0f));
+    model = glm::scale(model, glm::vec3(size, 1.0f));
+    return model;
+}
+
+// The SpriteRenderer before the constant attributes: a model matrix and two more uniforms per sprite
+class MatrixSpriteRenderer
+{
+public:
+    MatrixSpriteRenderer(Shader &shader)
+        : shader(shader)
+    {
+        float vertices[] = {
+                // pos      // tex
+                0.0f, 1.0f, 0.0f, 1.0f,
+                1.0f, 0.0f, 1.0f, 0.0f,
+                0.0f, 0.0f, 0.0f, 0.0f,
+
+                0.0f, 1.0f, 0.0f, 1.0f,
+                1.0f, 1.0f, 1.0f, 1.0f,
+                1.0f, 0.0f, 1.0f, 0.0f
+        };
+        glGenVertexArrays(1, &this->quadVAO);
+        glGenBuffers(1, &this->quadVBO);
+        GLStateCache::BindBuffer(GL_ARRAY_BUFFER, this->quadVBO);
+        glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
+        GLStateCache::BindVertexArray(this->quadVAO);
+        glEnableVertexAttribArray(0);
+        glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)0);
+        GLStateCache::BindBuffer(GL_ARRAY_BUFFER, 0);
+        GLStateCache::BindVertexArray(0);
+    }
+    ~MatrixSpriteRenderer()
+    {
+        GLStateCache::DeleteVertexArray(this->quadVAO);
+        GLStateCache::DeleteBuffer(this->quadVBO);
+    }
+    void DrawSprite(Texture2D &texture, glm::vec2 position, glm::vec2 size, float rotate, glm::vec3 color)
+    {
+        this->shader.Use();
+        this->shader.SetMatrix4("model", spriteModel(position, size, rotate));
+        this->shader.SetVector3f("spriteColor", color);
+        this->shader.SetVector4f("uvRect", texture.UV);
+        texture.Bind();
+        GLStateCache::BindVertexArray(this->quadVAO);
+        glDrawArrays(GL_TRIANGLES, 0, 6);
+    }
+
+private:
+    Shader shader;
+    unsigned int quadVAO, quadVBO;
+};
+
+// the frame in the window's back buffer
+static std::vector<unsigned char> readFrame()
+{
+    std::vector<unsigned char> pixels(SCREEN_WIDTH * SCREEN_HEIGHT * 4);
+    glReadPixels(0, 0, SCREEN_WIDTH, SCREEN_HEIGHT, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+    return pixels;
+}
+
+// largest difference of any channel between two frames
+static int maxDifference(const std::vector<unsigned char> &a, const std::vector<unsigned char> &b)
+{
+    int difference = 0;
+    for (size_t i = 0; i < a.size(); ++i)
+        difference = std::max(difference, std::abs(a[i] - b[i]));
+    return difference;
+}
+
+// milliseconds from the first call until the last one returns (CPU side only), best of frames runs of draw
+template <typename Draw>
+double TimeSubmit(Draw draw, unsigned int frames)
+{
+    double best = 1.0e30;
+    for (unsigned int i = 0; i < frames; ++i)
+    {
+        glFinish();
+        auto start = std::chrono::steady_clock::now();
+        draw();
+        best = std::min(best, std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+    }
+    glFinish();
+    return best;
+}
+
+// times both paths on the sprites, frames runs each
+static void run(unsigned int frames)
+{
+    ResourceManager::LoadShader("resources/shaders/Game/sprite.vs", "resources/shaders/Game/sprite.frag", nullptr,
+                                "sprite");
+    ResourceManager::LoadShader("resources/shaders/Game/sprite_unrotated.vs", "resources/shaders/Game/sprite.frag",
+                                nullptr, "sprite_unrotated");
+    Shader matrixShader;
+    matrixShader.Compile(MATRIX_VERTEX_SOURCE, MATRIX_FRAGMENT_SOURCE);
+    FrameData frame;
+    frame.Projection = glm::ortho(0.0f, static_cast<float>(SCREEN_WIDTH), static_cast<float>(SCREEN_HEIGHT), 0.0f,
+                                  -1.0f, 1.0f);
+    frame.ViewportSize = glm::vec2(SCREEN_WIDTH, SCREEN_HEIGHT);
+    frame.Upload();
+    ResourceManager::GetShader("sprite").Use().SetInteger("image", 0);
+    ResourceManager::GetShader("sprite_unrotated").Use().SetInteger("image", 0);
+    matrixShader.Use().SetInteger("image", 0);
+    matrixShader.SetMatrix4("projection", frame.Projection);
+    ResourceManager::AddToAtlas("resources/textures/block.png", false, "block");
+    ResourceManager::BuildAtlas();
+    Texture2D &texture = ResourceManager::GetTexture("block");
+    SpriteRenderer renderer(ResourceManager::GetShader("sprite"), ResourceManager::GetShader("sprite_unrotated"));
+    MatrixSpriteRenderer matrixRenderer(matrixShader);
+
+    // small sprites spread over the screen, so the raster work stays far below the per-sprite CPU cost
+    std::vector<Sprite> sprites(SPRITES);
+    for (unsigned int i = 0; i < SPRITES; ++i)
+        sprites[i] = { glm::vec2((i * 37) % (SCREEN_WIDTH - 4), (i * 53) % (SCREEN_HEIGHT - 4)), glm::vec2(4.0f, 3.0f),
+                       0.0f, glm::vec3(0.2f + (i % 5) * 0.2f, 0.6f, 1.0f - (i % 3) * 0.3f) };
+
+    std::printf("%u sprites, %u frames per path: best CPU time to submit them, mean frame time with glFinish\n",
+                SPRITES, frames);
+    // the matrix products alone, without any GL calls
+    volatile float sink;
+    double math = TimeSubmit([&]()
+    {
+        for (const Sprite &sprite : sprites)
+            sink = spriteModel(sprite.Position, sprite.Size, sprite.Rotation)[3][0];
+    }, frames);
+    std::printf("model matrix products alone: %.2f ms\n", math);
+    std::printf("%-24s %10s %10s %s\n", "path", "submit ms", "frame ms", "max diff");
+    for (float rotation : { 0.0f, 30.0f })
+    {
+        for (Sprite &sprite : sprites)
+            sprite.Rotation = rotation;
+        auto matrixPath = [&]()
+        {
+            glClear(GL_COLOR_BUFFER_BIT);
+            for (const Sprite &sprite : sprites)
+                matrixRenderer.DrawSprite(texture, sprite.Position, sprite.Size, sprite.Rotation, sprite.Color);
+        };
+        auto attributePath = [&]()
+        {
+            glClear(GL_COLOR_BUFFER_BIT);
+            for (const Sprite &sprite : sprites)
+                renderer.DrawSprite(texture, sprite.Position, sprite.Size, sprite.Rotation, sprite.Color);
+        };
+        double submit = TimeSubmit(matrixPath, frames);
+        double time = TimeFrames(matrixPath, frames);
+        std::vector<unsigned char> reference = readFrame();
+        std::printf("%-15s rot %4.0f %10.2f %10.2f %d\n", "model matrix", rotation, submit, time, 0);
+        submit = TimeSubmit(attributePath, frames);
+        time = TimeFrames(attributePath, frames);
+        std::printf("%-15s rot %4.0f %10.2f %10.2f %d\n", "constant attrib", rotation, submit, time,
+                    maxDifference(reference, readFrame()));
+    }
+    glDeleteProgram(matrixShader.ID);
+}
+
+int main(int argc, char *argv[])
+{
+    unsigned int frames = argc > 1 ? static_cast<unsigned int>(std::strtoul(argv[1], nullptr, 10)) : 5;
+    GLFWwindow *window = CreateBenchWindow(SCREEN_WIDTH, SCREEN_HEIGHT);
+    if (!window)
+        return -1;
+    run(std::max(frames, 1u));
+    ResourceManager::Clear();
+    glfwTerminate();
+    return 0;
+}
@@ -52,4 +52,5 @@ void BallObject::Reset(glm::vec2 position, glm::vec2 velocity)
     this->Position = position;
     this->Velocity = velocity;
     this->Stuck = true;
+    this->Trail.Clear();
 }
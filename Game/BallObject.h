@@ -6,6 +6,8 @@
 #define PROJEKT1_BALLOBJECT_H
 
 #include "GameObject.h"
+#include "RibbonTrail.h"
+
 // BallObject holds the state of the Ball object inheriting
 // relevant state data from GameObject. Contains some extra
 // functionality specific to Breakout's ball object that
@@ -17,6 +19,8 @@ public:
     float   Radius;
     bool    Stuck;
     bool    Sticky, PassThrough;
+    // where the ball has recently been
+    RibbonTrail Trail;
     // constructor(s)
     BallObject();
     BallObject(glm::vec2 pos, float radius, glm::vec2 velocity, Texture2D sprite);
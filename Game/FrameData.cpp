@@ -0,0 +1,43 @@
+#include "FrameData.h"
+#include "GLStateCache.h"
+
+#include <glm/gtc/type_ptr.hpp>
+
+
+// std140 layout of the FrameData block
+struct FrameDataBlock
+{
+    float Projection[16]; // offset 0
+    float ViewportSize[2]; // offset 64
+    float Time;           // offset 72
+    float Padding;        // block size is rounded up to a multiple of vec4
+};
+
+FrameData::FrameData()
+    : Projection(1.0f), ViewportSize(0.0f), Time(0.0f)
+{
+    glGenBuffers(1, &this->UBO);
+    GLStateCache::BindBuffer(GL_UNIFORM_BUFFER, this->UBO);
+    glBufferData(GL_UNIFORM_BUFFER, sizeof(FrameDataBlock), nullptr, GL_DYNAMIC_DRAW);
+    GLStateCache::BindBuffer(GL_UNIFORM_BUFFER, 0);
+    GLStateCache::BindBufferBase(GL_UNIFORM_BUFFER, FRAME_DATA_BINDING, this->UBO);
+}
+
+FrameData::~FrameData()
+{
+    GLStateCache::DeleteBuffer(this->UBO);
+}
+
+void FrameData::Upload()
+{
+    FrameDataBlock block = {};
+    const float *projection = glm::value_ptr(this->Projection);
+    for (int i = 0; i < 16; ++i)
+        block.Projection[i] = projection[i];
+    block.ViewportSize[0] = this->ViewportSize.x;
+    block.ViewportSize[1] = this->ViewportSize.y;
+    block.Time = this->Time;
+    GLStateCache::BindBuffer(GL_UNIFORM_BUFFER, this->UBO);
+    glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(block), &block);
+    GLStateCache::BindBuffer(GL_UNIFORM_BUFFER, 0);
+}
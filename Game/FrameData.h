@@ -0,0 +1,34 @@
+#ifndef PROJEKT1_FRAMEDATA_H
+#define PROJEKT1_FRAMEDATA_H
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+
+// binding point of the FrameData uniform block; Shader binds every program using the block to it
+const unsigned int FRAME_DATA_BINDING = 0;
+
+
+// FrameData owns the uniform buffer behind the std140 FrameData block
+// that all Game shaders read their projection, viewport size and time
+// from. Set the values and call Upload() once per frame (or whenever
+// the window/camera changes) instead of setting uniforms per program.
+class FrameData
+{
+public:
+    // per-frame state
+    glm::mat4 Projection;
+    glm::vec2 ViewportSize;
+    float     Time;
+    // constructor/destructor
+    FrameData();
+    ~FrameData();
+    // writes the current values into the uniform buffer
+    void Upload();
+
+private:
+    unsigned int UBO;
+};
+
+
+#endif //PROJEKT1_FRAMEDATA_H
@@ -0,0 +1,200 @@
+#include "GLStateCache.h"
+
+
+static const unsigned int UNKNOWN = ~0u;
+
+// Instantiate static variables
+GLStateCache::Counters GLStateCache::Frame = { 0, 0 };
+GLStateCache::Counters GLStateCache::LastFrame = { 0, 0 };
+unsigned int GLStateCache::program = UNKNOWN;
+unsigned int GLStateCache::activeUnit = UNKNOWN;
+unsigned int GLStateCache::textures[MAX_TEXTURE_UNITS] = { UNKNOWN, UNKNOWN, UNKNOWN, UNKNOWN, UNKNOWN, UNKNOWN, UNKNOWN, UNKNOWN,
+                                                           UNKNOWN, UNKNOWN, UNKNOWN, UNKNOWN, UNKNOWN, UNKNOWN, UNKNOWN, UNKNOWN };
+unsigned int GLStateCache::vertexArray = UNKNOWN;
+unsigned int GLStateCache::arrayBuffer = UNKNOWN;
+unsigned int GLStateCache::uniformBuffer = UNKNOWN;
+unsigned int GLStateCache::readFramebuffer = UNKNOWN;
+unsigned int GLStateCache::drawFramebuffer = UNKNOWN;
+unsigned int GLStateCache::blendEnabled = UNKNOWN;
+unsigned int GLStateCache::blendSource = UNKNOWN;
+unsigned int GLStateCache::blendDestination = UNKNOWN;
+
+
+void GLStateCache::BeginFrame()
+{
+    LastFrame = Frame;
+    Frame = { 0, 0 };
+}
+
+void GLStateCache::UseProgram(unsigned int program)
+{
+    if (change(GLStateCache::program, program))
+        glUseProgram(program);
+}
+
+void GLStateCache::ActiveTexture(unsigned int unit)
+{
+    if (change(activeUnit, unit))
+        glActiveTexture(GL_TEXTURE0 + unit);
+}
+
+void GLStateCache::BindTexture(unsigned int texture, unsigned int unit)
+{
+    if (unit >= MAX_TEXTURE_UNITS)
+    {
+        // untracked unit, always issue
+        ActiveTexture(unit);
+        glBindTexture(GL_TEXTURE_2D, texture);
+        ++Frame.Issued;
+        return;
+    }
+    if (textures[unit] == texture)
+    {
+        ++Frame.Elided;
+        return;
+    }
+    ActiveTexture(unit);
+    change(textures[unit], texture);
+    glBindTexture(GL_TEXTURE_2D, texture);
+}
+
+void GLStateCache::BindVertexArray(unsigned int vertexArray)
+{
+    if (change(GLStateCache::vertexArray, vertexArray))
+        glBindVertexArray(vertexArray);
+}
+
+void GLStateCache::BindBuffer(GLenum target, unsigned int buffer)
+{
+    unsigned int *cached = bufferBinding(target);
+    if (cached == nullptr)
+    {
+        glBindBuffer(target, buffer);
+        ++Frame.Issued;
+        return;
+    }
+    if (change(*cached, buffer))
+        glBindBuffer(target, buffer);
+}
+
+void GLStateCache::BindBufferBase(GLenum target, unsigned int index, unsigned int buffer)
+{
+    // indexed bindings are set up once, always issue; they also replace the generic binding
+    glBindBufferBase(target, index, buffer);
+    ++Frame.Issued;
+    if (unsigned int *cached = bufferBinding(target))
+        *cached = buffer;
+}
+
+void GLStateCache::BindFramebuffer(GLenum target, unsigned int framebuffer)
+{
+    if (target == GL_FRAMEBUFFER)
+    {
+        if (readFramebuffer == framebuffer && drawFramebuffer == framebuffer)
+        {
+            ++Frame.Elided;
+            return;
+        }
+        readFramebuffer = drawFramebuffer = framebuffer;
+        glBindFramebuffer(target, framebuffer);
+        ++Frame.Issued;
+        return;
+    }
+    if (change(target == GL_READ_FRAMEBUFFER ? readFramebuffer : drawFramebuffer, framebuffer))
+        glBindFramebuffer(target, framebuffer);
+}
+
+void GLStateCache::SetBlend(bool enabled)
+{
+    if (change(blendEnabled, enabled ? 1 : 0))
+    {
+        if (enabled)
+            glEnable(GL_BLEND);
+        else
+            glDisable(GL_BLEND);
+    }
+}
+
+void GLStateCache::BlendFunc(GLenum source, GLenum destination)
+{
+    if (blendSource == source && blendDestination == destination)
+    {
+        ++Frame.Elided;
+        return;
+    }
+    blendSource = source;
+    blendDestination = destination;
+    glBlendFunc(source, destination);
+    ++Frame.Issued;
+}
+
+void GLStateCache::DeleteProgram(unsigned int program)
+{
+    if (GLStateCache::program == program)
+        GLStateCache::program = 0;
+    glDeleteProgram(program);
+}
+
+void GLStateCache::DeleteTexture(unsigned int texture)
+{
+    // deleting a bound texture reverts the binding to 0 on every unit
+    for (unsigned int &bound : textures)
+        if (bound == texture)
+            bound = 0;
+    glDeleteTextures(1, &texture);
+}
+
+void GLStateCache::DeleteVertexArray(unsigned int vertexArray)
+{
+    if (GLStateCache::vertexArray == vertexArray)
+        GLStateCache::vertexArray = 0;
+    glDeleteVertexArrays(1, &vertexArray);
+}
+
+void GLStateCache::DeleteBuffer(unsigned int buffer)
+{
+    if (arrayBuffer == buffer)
+        arrayBuffer = 0;
+    if (uniformBuffer == buffer)
+        uniformBuffer = 0;
+    glDeleteBuffers(1, &buffer);
+}
+
+void GLStateCache::DeleteFramebuffer(unsigned int framebuffer)
+{
+    if (readFramebuffer == framebuffer)
+        readFramebuffer = 0;
+    if (drawFramebuffer == framebuffer)
+        drawFramebuffer = 0;
+    glDeleteFramebuffers(1, &framebuffer);
+}
+
+void GLStateCache::Invalidate()
+{
+    program = activeUnit = vertexArray = UNKNOWN;
+    for (unsigned int &bound : textures)
+        bound = UNKNOWN;
+    arrayBuffer = uniformBuffer = readFramebuffer = drawFramebuffer = UNKNOWN;
+    blendEnabled = blendSource = blendDestination = UNKNOWN;
+}
+
+bool GLStateCache::change(unsigned int &cached, unsigned int value)
+{
+    if (cached == value)
+    {
+        ++Frame.Elided;
+        return false;
+    }
+    cached = value;
+    ++Frame.Issued;
+    return true;
+}
+
+unsigned int *GLStateCache::bufferBinding(GLenum target)
+{
+    if (target == GL_ARRAY_BUFFER)
+        return &arrayBuffer;
+    if (target == GL_UNIFORM_BUFFER)
+        return &uniformBuffer;
+    return nullptr;
+}
@@ -0,0 +1,59 @@
+#ifndef PROJEKT1_GLSTATECACHE_H
+#define PROJEKT1_GLSTATECACHE_H
+
+#include <glad/glad.h>
+
+
+// A static GLStateCache that all of Game/ routes its program, texture,
+// vertex array, buffer, framebuffer and blend state changes through.
+// It remembers what is currently bound and skips calls that would not
+// change anything, counting issued versus elided calls per frame.
+// Objects have to be deleted through the cache as well, so a recycled
+// object name is never mistaken for the one that is still "bound".
+class GLStateCache
+{
+public:
+    // number of state calls passed on to the driver / skipped as redundant
+    struct Counters
+    {
+        unsigned int Issued, Elided;
+    };
+    // counters of the frame in progress and of the last finished frame
+    static Counters Frame, LastFrame;
+    // starts counting a new frame
+    static void BeginFrame();
+    // state changes
+    static void UseProgram(unsigned int program);
+    static void ActiveTexture(unsigned int unit); // unit index, not GL_TEXTUREi
+    static void BindTexture(unsigned int texture, unsigned int unit = 0); // GL_TEXTURE_2D on the given unit
+    static void BindVertexArray(unsigned int vertexArray);
+    static void BindBuffer(GLenum target, unsigned int buffer);
+    static void BindBufferBase(GLenum target, unsigned int index, unsigned int buffer);
+    static void BindFramebuffer(GLenum target, unsigned int framebuffer);
+    static void SetBlend(bool enabled);
+    static void BlendFunc(GLenum source, GLenum destination);
+    // object deletion, also forgets bindings of the deleted object
+    static void DeleteProgram(unsigned int program);
+    static void DeleteTexture(unsigned int texture);
+    static void DeleteVertexArray(unsigned int vertexArray);
+    static void DeleteBuffer(unsigned int buffer);
+    static void DeleteFramebuffer(unsigned int framebuffer);
+    // forgets all cached state, e.g. after code outside Game/ touched the context
+    static void Invalidate();
+
+private:
+    static const unsigned int MAX_TEXTURE_UNITS = 16;
+    // cached state; ~0u means unknown
+    static unsigned int program, activeUnit, textures[MAX_TEXTURE_UNITS], vertexArray;
+    static unsigned int arrayBuffer, uniformBuffer, readFramebuffer, drawFramebuffer;
+    static unsigned int blendEnabled, blendSource, blendDestination;
+    // private constructor, the cache only has static members
+    GLStateCache() { }
+    // counts a call and returns whether it has to be issued
+    static bool change(unsigned int &cached, unsigned int value);
+    // cached binding of a buffer target (nullptr if the target isn't tracked)
+    static unsigned int *bufferBinding(GLenum target);
+};
+
+
+#endif //PROJEKT1_GLSTATECACHE_H
@@ -9,13 +9,23 @@
 #include FT_FREETYPE_H
 #include FT_GLYPH_H
 
-#include "ParticleGenerator.h"
+#include "ParticleSystem.h"
+#include "GpuParticleGenerator.h"
+#include "ThreadPool.h"
+#include "Random.h"
+#include "RibbonTrail.h"
+#include "QualityGovernor.h"
 #include "PostProcessor.h"
 #include "TextRenderer.h"
 using namespace irrklang;
 
 #include "ResourceManager.h"
 #include "SpriteRenderer.h"
+#include "SpriteBatch.h"
+#include "RenderQueue.h"
+#include "FrameData.h"
+#include "GLStateCache.h"
+#include "StreamBuffer.h"
 #include "GLFW/glfw3.h"
 
 #define LEVEL1_PATH "resources/levels/level1.lvl"
@@ -24,27 +34,62 @@ using namespace irrklang;
 #define LEVEL4_PATH "resources/levels/level4.lvl"
 // Game-related State data
 SpriteRenderer* Renderer;
+SpriteBatch* Batch;
+RenderQueue* Queue;
+FrameData* Frame;
 GameObject* Player;
 BallObject* Ball;
-ParticleGenerator* Particles;
+ParticleSystem* Particles;
+GpuParticleGenerator* GpuTrail;
+ThreadPool* Workers;
+RibbonRenderer* Ribbons;
+QualityGovernor* Governor;
 PostProcessor* Effects;
 ISoundEngine* SoundEngine = createIrrKlangDevice();
 TextRenderer* Text;
 
 float ShakeTime = 0.0f;
 
+// particle emitters
+unsigned int BallTrail, PowerUpTrail, BrickBurst, PaddleSparks;
+
+// frame time (ms) the quality governor keeps frames under
+const float FRAME_BUDGET = 1000.0f / 60.0f;
+// quality knobs: particles, MSAA samples, render scale, effects, text resolution; the worst allowed,
+// and the best for an anti-aliasing mode, whose samples the MSAA steps of the ladder go down from
+const QualityKnobs WORST_QUALITY = { 0.25f, 0, 0.5f, EFFECTS_REDUCED, 0.5f };
+
+QualityKnobs bestQuality(AntiAliasing aa)
+{
+    return { 1.0f, PostProcessor::AntiAliasingSamples(aa), 1.0f, EFFECTS_FULL, 1.0f };
+}
+
+// number of particles to spawn instead of count at the governor's current quality
+unsigned int ScaledParticles(unsigned int count)
+{
+    return std::max(1u, static_cast<unsigned int>(count * Governor->Knobs().ParticleScale + 0.5f));
+}
+
 
 Game::Game(unsigned int width, unsigned int height)
-    : State(GAME_MENU), Keys(), KeysProcessed(), Width(width), Height(height), Level(0), Lives(3)
+    : State(GAME_MENU), Keys(), KeysProcessed(), Width(width), Height(height), Level(0), Lives(3),
+      ShowStats(false), GpuParticles(false), RibbonTrails(true), Bloom(false), AA(AA_MSAA_4X), FrameTime(0.0f), screenCached(false), cachedState(GAME_MENU), cachedLevel(0), cachedLives(0)
 {
 }
 
 Game::~Game()
 {
     delete Renderer;
+    delete Batch;
+    delete Queue;
+    delete Frame;
     delete Player;
     delete Ball;
     delete Particles;
+    delete GpuTrail;
+    delete Workers;
+    delete Ribbons;
+    delete Governor;
     delete Effects;
     delete Text;
     SoundEngine->drop();
@@ -55,38 +100,64 @@ void Game::Init()
     // load shaders
     ResourceManager::LoadShader("resources/shaders/Game/sprite.vs", "resources/shaders/Game/sprite.frag", nullptr,
                                 "sprite");
-    ResourceManager::LoadShader("resources/shaders/Game/particle.vs", "resources/shaders/Game/particle.frag", nullptr,
-                                "particle");
+    ResourceManager::LoadShader("resources/shaders/Game/sprite_unrotated.vs", "resources/shaders/Game/sprite.frag",
+                                nullptr, "sprite_unrotated");
+    ResourceManager::LoadShader("resources/shaders/Game/particle_gpu.vs", "resources/shaders/Game/particle.frag",
+                                nullptr, "particle_gpu");
+    ResourceManager::LoadFeedbackShader("resources/shaders/Game/particle_update.vs",
+                                        { "outPositionVelocity", "outColor", "outLifeSize" }, "particle_update");
+    ResourceManager::LoadShader("resources/shaders/Game/ribbon.vs", "resources/shaders/Game/ribbon.frag", nullptr,
+                                "ribbon");
     ResourceManager::LoadShader("resources/shaders/Game/post_processing.vs",
                                 "resources/shaders/Game/post_processing.frag", nullptr,
                                 "postprocessing");
-    // configure shaders
-    glm::mat4 projection = glm::ortho(0.0f, static_cast<float>(this->Width),
-                                      static_cast<float>(this->Height), 0.0f, -1.0f, 1.0f);
+    ResourceManager::LoadShader("resources/shaders/Game/post_processing.vs", "resources/shaders/Game/post_chain.frag",
+                                nullptr, "postchain");
+    // configure shaders; projection, viewport and time are shared by all programs through the FrameData block
+    Frame = new FrameData();
+    Frame->Projection = glm::ortho(0.0f, static_cast<float>(this->Width),
+                                   static_cast<float>(this->Height), 0.0f, -1.0f, 1.0f);
+    Frame->ViewportSize = glm::vec2(this->Width, this->Height);
+    Frame->Upload();
     ResourceManager::GetShader("sprite").Use().SetInteger("image", 0);
-    ResourceManager::GetShader("sprite").SetMatrix4("projection", projection);
-    ResourceManager::GetShader("particle").Use().SetInteger("sprite", 0);
-    ResourceManager::GetShader("particle").SetMatrix4("projection", projection);
-    // load textures
-    ResourceManager::LoadTexture("resources/textures/background.jpg", false, "background");
-    ResourceManager::LoadTexture("resources/textures/awesomeface.png", true, "face");
-    ResourceManager::LoadTexture("resources/textures/block.png", false, "block");
-    ResourceManager::LoadTexture("resources/textures/block_solid.png", false, "block_solid");
-    ResourceManager::LoadTexture("resources/textures/paddle.png", true, "paddle");
-    ResourceManager::LoadTexture("resources/textures/particle.png", true, "particle");
-    ResourceManager::LoadTexture("resources/textures/powerup_speed.png", true, "powerup_speed");
-    ResourceManager::LoadTexture("resources/textures/powerup_sticky.png", true, "powerup_sticky");
-    ResourceManager::LoadTexture("resources/textures/powerup_increase.png", true, "powerup_increase");
-    ResourceManager::LoadTexture("resources/textures/powerup_confuse.png", true, "powerup_confuse");
-    ResourceManager::LoadTexture("resources/textures/powerup_chaos.png", true, "powerup_chaos");
-    ResourceManager::LoadTexture("resources/textures/powerup_passthrough.png", true, "powerup_passthrough");
+    ResourceManager::GetShader("sprite_unrotated").Use().SetInteger("image", 0);
+    ResourceManager::GetShader("particle_gpu").Use().SetInteger("sprite", 0);
+    // load textures, packed into as few atlas pages as possible so sprites rarely need a texture switch
+    ResourceManager::AddToAtlas("resources/textures/background.jpg", false, "background");
+    ResourceManager::AddToAtlas("resources/textures/awesomeface.png", true, "face");
+    ResourceManager::AddToAtlas("resources/textures/block.png", false, "block");
+    ResourceManager::AddToAtlas("resources/textures/block_solid.png", false, "block_solid");
+    ResourceManager::AddToAtlas("resources/textures/paddle.png", true, "paddle");
+    ResourceManager::AddToAtlas("resources/textures/particle.png", true, "particle");
+    ResourceManager::AddToAtlas("resources/textures/powerup_speed.png", true, "powerup_speed");
+    ResourceManager::AddToAtlas("resources/textures/powerup_sticky.png", true, "powerup_sticky");
+    ResourceManager::AddToAtlas("resources/textures/powerup_increase.png", true, "powerup_increase");
+    ResourceManager::AddToAtlas("resources/textures/powerup_confuse.png", true, "powerup_confuse");
+    ResourceManager::AddToAtlas("resources/textures/powerup_chaos.png", true, "powerup_chaos");
+    ResourceManager::AddToAtlas("resources/textures/powerup_passthrough.png", true, "powerup_passthrough");
+    ResourceManager::BuildAtlas();
     // set render-specific controls
-    Renderer = new SpriteRenderer(ResourceManager::GetShader("sprite"));
-    Particles = new ParticleGenerator(ResourceManager::GetShader("particle"), ResourceManager::GetTexture("particle"),
-                                      500);
-    Effects = new PostProcessor(ResourceManager::GetShader("postprocessing"), this->Width, this->Height);
-    Text = new TextRenderer(this->Width, this->Height);
+    Renderer = new SpriteRenderer(ResourceManager::GetShader("sprite"), ResourceManager::GetShader("sprite_unrotated"));
+    Batch = new SpriteBatch(ResourceManager::GetShader("sprite"), ResourceManager::GetShader("sprite_unrotated"));
+    Queue = new RenderQueue();
+    Particles = new ParticleSystem(ResourceManager::GetTexture("particle"), 2000);
+    // one worker per core besides the main thread, for pools past ParticleSystem::PARALLEL_THRESHOLD
+    Workers = new ThreadPool(std::max(std::thread::hardware_concurrency(), 1u) - 1);
+    Particles->Workers = Workers;
+    // emitters: shape, budget, life, size, speed
+    BallTrail = Particles->AddEmitter({ EMITTER_TRAIL, 500, 1.0f, 10.0f, 0.0f });
+    PowerUpTrail = Particles->AddEmitter({ EMITTER_TRAIL, 300, 0.5f, 6.0f, 0.0f });
+    BrickBurst = Particles->AddEmitter({ EMITTER_BURST, 800, 0.4f, 6.0f, 150.0f });
+    PaddleSparks = Particles->AddEmitter({ EMITTER_SPARKS, 200, 0.3f, 4.0f, 250.0f });
+    GpuTrail = new GpuParticleGenerator(ResourceManager::GetShader("particle_update"),
+                                        ResourceManager::GetShader("particle_gpu"),
+                                        ResourceManager::GetTexture("particle"), 500);
+    Ribbons = new RibbonRenderer(ResourceManager::GetShader("ribbon"));
+    Effects = new PostProcessor("postprocessing", "postchain", this->Width, this->Height);
+    Effects->SetAntiAliasing(this->AA);
+    Text = new TextRenderer();
     Text->Load("resources/fonts/OCRAEXT.TTF", 24);
+    Governor = new QualityGovernor(bestQuality(this->AA), WORST_QUALITY, FRAME_BUDGET);
     // load levels
     GameLevel one;
     one.Load(LEVEL1_PATH, this->Width, this->Height / 2);
@@ -112,12 +183,29 @@ void Game::Init()
 
 void Game::Update(float dt)
 {
+    // smoothed frame time for the stats overlay
+    this->FrameTime += (dt - this->FrameTime) * 0.05f;
     // update objects
     Ball->Move(dt, this->Width);
     // check for collisions
     this->DoCollisions();
-    // update particles
-    Particles->Update(dt, *Ball, 2, glm::vec2(Ball->Radius / 2.0f));
+    // update trails: the ball and falling powerups leave ribbons, or particles with ribbons off; the ball's
+    // particle trail is simulated on the CPU or the GPU, the other backend keeps running until its particles faded out
+    Ball->Trail.Record(Ball->Position + Ball->Radius, dt);
+    bool particleTrail = !this->RibbonTrails;
+    if (particleTrail && !this->GpuParticles)
+        Particles->Emit(BallTrail, Ball->Position + Ball->Radius / 2.0f, ScaledParticles(2), Ball->Velocity);
+    GpuTrail->Update(dt, *Ball, particleTrail && this->GpuParticles ? ScaledParticles(2) : 0,
+                     glm::vec2(Ball->Radius / 2.0f));
+    for (PowerUp& powerUp : this->PowerUps)
+        if (!powerUp.Destroyed)
+        {
+            powerUp.Trail.Record(powerUp.Position + glm::vec2(powerUp.Size.x / 2.0f, 0.0f), dt);
+            if (particleTrail)
+                Particles->Emit(PowerUpTrail, powerUp.Position + glm::vec2(powerUp.Size.x / 2.0f, 0.0f), ScaledParticles(1),
+                                powerUp.Velocity, powerUp.Color);
+        }
+    Particles->Update(dt);
     // update PowerUps
     this->UpdatePowerUps(dt);
     // reduce shake time
@@ -153,6 +241,40 @@ void Game::Update(float dt)
 
 void Game::ProcessInput(float dt)
 {
+    if (this->Keys[GLFW_KEY_F3] && !this->KeysProcessed[GLFW_KEY_F3])
+    {
+        this->ShowStats = !this->ShowStats;
+        this->KeysProcessed[GLFW_KEY_F3] = true;
+    }
+    if (this->Keys[GLFW_KEY_F4] && !this->KeysProcessed[GLFW_KEY_F4])
+    {
+        this->GpuParticles = !this->GpuParticles;
+        this->KeysProcessed[GLFW_KEY_F4] = true;
+    }
+    if (this->Keys[GLFW_KEY_F5] && !this->KeysProcessed[GLFW_KEY_F5])
+    {
+        this->RibbonTrails = !this->RibbonTrails;
+        this->KeysProcessed[GLFW_KEY_F5] = true;
+    }
+    if (this->Keys[GLFW_KEY_F6] && !this->KeysProcessed[GLFW_KEY_F6])
+    {
+        this->Bloom = !this->Bloom;
+        Effects->ClearChain();
+        if (this->Bloom)
+            Effects->AddBloom(0.7f, 0.8f, 5);
+        this->screenCached = false; // a cached menu screen was rendered without (or with) it
+        this->KeysProcessed[GLFW_KEY_F6] = true;
+    }
+    if (this->Keys[GLFW_KEY_F7] && !this->KeysProcessed[GLFW_KEY_F7])
+    {
+        this->AA = static_cast<AntiAliasing>((this->AA + 1) % AA_MODES);
+        Effects->SetAntiAliasing(this->AA);
+        // the MSAA steps of the quality ladder start from the samples of the new mode
+        Governor->SetRange(bestQuality(this->AA), WORST_QUALITY);
+        this->applyQuality();
+        this->screenCached = false;
+        this->KeysProcessed[GLFW_KEY_F7] = true;
+    }
     if (this->State == GAME_MENU)
     {
         if (this->Keys[GLFW_KEY_ENTER] && !this->KeysProcessed[GLFW_KEY_ENTER])
@@ -213,49 +335,169 @@ void Game::ProcessInput(float dt)
     }
 }
 
+void Game::BeginFrame()
+{
+    Governor->BeginFrame();
+}
+
+void Game::EndFrame()
+{
+    // apply whatever the governor decided for the frames to come
+    if (Governor->EndFrame())
+        this->applyQuality();
+}
+
+void Game::Resize(unsigned int width, unsigned int height)
+{
+    Effects->Resize(width, height);
+    // glyphs are rasterized for the new pixel density, and the cached screen is of the old size
+    this->applyQuality();
+    this->screenCached = false;
+}
+
+void Game::applyQuality()
+{
+    const QualityKnobs& knobs = Governor->Knobs();
+    Effects->SetSamples(knobs.Samples);
+    Effects->SetRenderScale(knobs.RenderScale);
+    Effects->Quality = knobs.Effects;
+    // text is drawn straight at the framebuffer size, scaled from the logical one
+    Text->SetResolution(knobs.TextScale * Effects->OutputHeight / this->Height);
+}
+
 void Game::Render()
 {
     if (this->State == GAME_ACTIVE || this->State == GAME_MENU || this->State == GAME_WIN)
     {
-        // begin rendering to postprocessing framebuffer
-        Effects->BeginRender();
-        // draw background
-        Renderer->DrawSprite(ResourceManager::GetTexture("background"), glm::vec2(0.0f, 0.0f),
-                             glm::vec2(this->Width, this->Height), 0.0f);
-        // draw level
-        this->Levels[this->Level].Draw(*Renderer);
-        // draw player
-        Player->Draw(*Renderer);
-        // draw PowerUps
-        for (PowerUp& powerUp : this->PowerUps)
-            if (!powerUp.Destroyed)
-                powerUp.Draw(*Renderer);
-        // draw particles
-        Particles->Draw();
-        // draw ball
-        Ball->Draw(*Renderer);
-        // end rendering to postprocessing framebuffer
-        Effects->EndRender();
-        // render postprocessing quad
-        Effects->Render(glfwGetTime());
+        GLStateCache::BeginFrame();
+        // statistics of the previous frame, before the counters are reset
+        std::string stats = this->ShowStats ? this->StatsText() : "";
+        Batch->ResetStats();
+        Queue->ResetStats();
+        // update the per-frame data shared by all shaders
+        Frame->Time = static_cast<float>(glfwGetTime());
+        Frame->Upload();
+        // static screens re-present their cached scene until what they show changes
+        bool staticScreen = this->StaticScreen();
+        if (!staticScreen || !this->screenCached || this->cachedState != this->State ||
+            this->cachedLevel != this->Level || this->cachedLives != this->Lives)
+            this->renderScene(staticScreen);
+        if (staticScreen)
+            Effects->PresentCache();
         // render text (don't include in postprocessing)
         std::stringstream ss;
         ss << this->Lives;
-        Text->RenderText("Lives:" + ss.str(), 5.0f, 5.0f, 1.0f);
+        this->queueText("Lives:" + ss.str(), 5.0f, 5.0f, 1.0f);
+        if (this->ShowStats)
+        {
+            std::stringstream gl;
+            gl << "gl: " << GLStateCache::LastFrame.Issued << " issued, " << GLStateCache::LastFrame.Elided << " elided"
+               << " | quality " << Governor->Level() << "/" << Governor->Levels() - 1 << ": "
+               << QualityGovernor::Describe(Governor->Knobs());
+            this->queueText(stats, 5.0f, this->Height - 38.0f, 0.6f, glm::vec3(1.0f, 1.0f, 0.0f));
+            this->queueText(gl.str(), 5.0f, this->Height - 20.0f, 0.6f, glm::vec3(1.0f, 1.0f, 0.0f));
+        }
     }
     if (this->State == GAME_MENU)
     {
-        Text->RenderText("Press ENTER to start", 250.0f, this->Height / 2.0f, 1.0f);
-        Text->RenderText("Press W or S to select level", 245.0f, this->Height / 2.0f + 20.0f, 0.75f);
+        this->queueText("Press ENTER to start", 250.0f, this->Height / 2.0f, 1.0f);
+        this->queueText("Press W or S to select level", 245.0f, this->Height / 2.0f + 20.0f, 0.75f);
     }
     if (this->State == GAME_WIN)
     {
-        Text->RenderText("You WON!!!", 320.0f, this->Height / 2.0f - 20.0f, 1.0f, glm::vec3(0.0f, 1.0f, 0.0f));
-        Text->RenderText("Press ENTER to retry or ESC to quit", 130.0f, this->Height / 2.0f, 1.0f,
-                         glm::vec3(1.0f, 1.0f, 0.0f));
+        this->queueText("You WON!!!", 320.0f, this->Height / 2.0f - 20.0f, 1.0f, glm::vec3(0.0f, 1.0f, 0.0f));
+        this->queueText("Press ENTER to retry or ESC to quit", 130.0f, this->Height / 2.0f, 1.0f,
+                        glm::vec3(1.0f, 1.0f, 0.0f));
     }
+    Queue->Flush();
+    // everything streamed this frame has been drawn
+    StreamBuffer::EndFrame();
 }
 
+bool Game::StaticScreen() const
+{
+    return this->State == GAME_MENU || this->State == GAME_WIN;
+}
+
+void Game::renderScene(bool toCache)
+{
+    // none of the scene sprites are rotated
+    const unsigned int spriteShader = ResourceManager::GetShader("sprite_unrotated").ID;
+    // begin rendering to postprocessing framebuffer
+    Effects->BeginRender();
+    // draw background (fully opaque, no need to blend)
+    Texture2D& background = ResourceManager::GetTexture("background");
+    Queue->Submit(LAYER_BACKGROUND, BLEND_OPAQUE, spriteShader, background.ID, [this, &background]()
+    {
+        Renderer->DrawSprite(background, glm::vec2(0.0f, 0.0f), glm::vec2(this->Width, this->Height), 0.0f);
+    });
+    // draw level
+    GameLevel& level = this->Levels[this->Level];
+    Queue->Submit(LAYER_LEVEL, BLEND_PREMULTIPLIED, spriteShader,
+                  ResourceManager::GetTexture("block").ID, [&level]() { level.Draw(*Batch); });
+    // draw the GPU trails (additive, so they glow over the bricks and under the sprites) while any are alive
+    if (GpuTrail->Active())
+        Queue->Submit(LAYER_TRAILS, BLEND_PREMULTIPLIED, ResourceManager::GetShader("particle_gpu").ID,
+                      ResourceManager::GetTexture("particle").ID, []() { GpuTrail->Draw(); });
+    if (this->RibbonTrails)
+    {
+        const unsigned int ribbonShader = ResourceManager::GetShader("ribbon").ID;
+        Queue->Submit(LAYER_TRAILS, BLEND_PREMULTIPLIED, ribbonShader, 0,
+                      []() { Ribbons->Draw(Ball->Trail, glm::vec3(0.8f), Ball->Radius * 1.6f); });
+        for (PowerUp& powerUp : this->PowerUps)
+            if (!powerUp.Destroyed)
+                Queue->Submit(LAYER_TRAILS, BLEND_PREMULTIPLIED, ribbonShader, 0,
+                              [&powerUp]() { Ribbons->Draw(powerUp.Trail, powerUp.Color, 8.0f); });
+    }
+    // draw player, PowerUps, particles and ball as one batch; with premultiplied alpha the additive particles
+    // ('glow' effect) and the alpha blended sprites share the atlas draw call, the batch keeps their order
+    Queue->Submit(LAYER_SPRITES, BLEND_PREMULTIPLIED, spriteShader, Player->Sprite.ID, [this]()
+    {
+        Batch->Begin();
+        Player->Draw(*Batch);
+        for (PowerUp& powerUp : this->PowerUps)
+            if (!powerUp.Destroyed)
+                powerUp.Draw(*Batch);
+        Particles->Draw(*Batch);
+        Ball->Draw(*Batch);
+        Batch->Flush();
+    });
+    Queue->Flush();
+    // end rendering to postprocessing framebuffer
+    Effects->EndRender();
+    // render postprocessing quad
+    if (toCache)
+    {
+        Effects->RenderToCache();
+        this->cachedState = this->State;
+        this->cachedLevel = this->Level;
+        this->cachedLives = this->Lives;
+    }
+    else
+        Effects->Render();
+    this->screenCached = toCache;
+}
+
+void Game::queueText(std::string text, float x, float y, float scale, glm::vec3 color)
+{
+    Queue->Submit(LAYER_OVERLAY, BLEND_PREMULTIPLIED, Text->TextShader.ID, 0, [text, x, y, scale, color]()
+    {
+        Text->RenderText(text, x, y, scale, color);
+    });
+}
+
+std::string Game::StatsText()
+{
+    std::stringstream ss;
+    ss.precision(2);
+    ss << std::fixed << this->FrameTime * 1000.0f << " ms | batch: " << Batch->Sprites << " sprites, "
+        << Batch->DrawCalls << " draws | queue: " << Queue->Commands << " cmds, " << Queue->StateChanges
+        << " state changes (" << Queue->StateChangesElided << " elided) | trail: "
+        << (this->RibbonTrails ? "ribbon" : this->GpuParticles ? "GPU" : "CPU") << " | bloom: "
+        << (this->Bloom ? "on" : "off") << " | AA: " << PostProcessor::AntiAliasingName(this->AA) << " | gpu "
+        << Governor->GpuTime << " ms";
+    return ss.str();
+}
 
 void Game::ResetLevel()
 {
@@ -344,32 +586,42 @@ void Game::UpdatePowerUps(float dt)
                          ), this->PowerUps.end());
 }
 
-bool ShouldSpawn(unsigned int chance)
+// what a destroyed brick can drop and how likely each drop is
+struct PowerUpDrop
 {
-    unsigned int random = rand() % chance;
-    return random == 0;
-}
+    PowerUpType Type;
+    glm::vec3   Color;
+    float       Duration;
+    const char *Texture;
+    float       Chance;
+};
+
+static const PowerUpDrop POWERUP_DROPS[] = {
+    { SPEED,             glm::vec3(0.5f, 0.5f, 1.0f),  0.0f, "powerup_speed",       1.0f / 75.0f },
+    { STICKY,            glm::vec3(1.0f, 0.5f, 1.0f), 20.0f, "powerup_sticky",      1.0f / 75.0f },
+    { PASS_THROUGH,      glm::vec3(0.5f, 1.0f, 0.5f), 10.0f, "powerup_passthrough", 1.0f / 75.0f },
+    { PAD_SIZE_INCREASE, glm::vec3(1.0f, 0.6f, 0.4f),  0.0f, "powerup_increase",    1.0f / 75.0f },
+    // negative powerups should spawn more often
+    { CONFUSE,           glm::vec3(1.0f, 0.3f, 0.3f), 15.0f, "powerup_confuse",     1.0f / 15.0f },
+    { CHAOS,             glm::vec3(0.9f, 0.25f, 0.25f), 15.0f, "powerup_chaos",     1.0f / 15.0f }
+};
 
 void Game::SpawnPowerUps(GameObject& block)
 {
-    if (ShouldSpawn(75)) // 1 in 75 chance
-        this->PowerUps.emplace_back(SPEED, glm::vec3(0.5f, 0.5f, 1.0f), 0.0f, block.Position,
-                                         ResourceManager::GetTexture("powerup_speed"));
-    if (ShouldSpawn(75))
-        this->PowerUps.emplace_back(STICKY, glm::vec3(1.0f, 0.5f, 1.0f), 20.0f, block.Position,
-                                         ResourceManager::GetTexture("powerup_sticky"));
-    if (ShouldSpawn(75))
-        this->PowerUps.emplace_back(PASS_THROUGH, glm::vec3(0.5f, 1.0f, 0.5f), 10.0f, block.Position,
-                                         ResourceManager::GetTexture("powerup_passthrough"));
-    if (ShouldSpawn(75))
-        this->PowerUps.emplace_back(PAD_SIZE_INCREASE, glm::vec3(1.0f, 0.6f, 0.4), 0.0f, block.Position,
-                                         ResourceManager::GetTexture("powerup_increase"));
-    if (ShouldSpawn(15)) // Negative powerups should spawn more often
-        this->PowerUps.emplace_back(CONFUSE, glm::vec3(1.0f, 0.3f, 0.3f), 15.0f, block.Position,
-                                         ResourceManager::GetTexture("powerup_confuse"));
-    if (ShouldSpawn(15))
-        this->PowerUps.emplace_back(CHAOS, glm::vec3(0.9f, 0.25f, 0.25f), 15.0f, block.Position,
-                                         ResourceManager::GetTexture("powerup_chaos"));
+    // a single draw decides which powerup (if any) drops
+    static const DiscreteDistribution drops([]()
+    {
+        std::vector<float> chances;
+        for (const PowerUpDrop& drop : POWERUP_DROPS)
+            chances.push_back(drop.Chance);
+        return chances;
+    }(), 1.0f);
+    unsigned int pick = drops.Pick(Random::Stream(RANDOM_GAMEPLAY));
+    if (pick == drops.Count())
+        return;
+    const PowerUpDrop& drop = POWERUP_DROPS[pick];
+    this->PowerUps.emplace_back(drop.Type, drop.Color, drop.Duration, block.Position,
+                                ResourceManager::GetTexture(drop.Texture));
 }
 
 void ActivatePowerUp(const PowerUp& powerUp)
@@ -426,8 +678,10 @@ Direction VectorDirection(glm::vec2 closest);
 
 void Game::DoCollisions()
 {
-    for (GameObject& box : this->Levels[this->Level].Bricks)
+    GameLevel& level = this->Levels[this->Level];
+    for (unsigned int i = 0; i < level.Bricks.size(); ++i)
     {
+        GameObject& box = level.Bricks[i];
         if (!box.Destroyed)
         {
             Collision collision = CheckCollision(*Ball, box);
@@ -436,7 +690,8 @@ void Game::DoCollisions()
                 // destroy block if not solid
                 if (!box.IsSolid)
                 {
-                    box.Destroyed = true;
+                    level.DestroyBrick(i);
+                    Particles->Emit(BrickBurst, box.Position, ScaledParticles(24), glm::vec2(0.0f), box.Color, box.Size);
                     this->SpawnPowerUps(box);
                     SoundEngine->play2D("resources/audio/bleep.mp3", false);
                 }
@@ -518,6 +773,9 @@ void Game::DoCollisions()
 
         // if Sticky powerup is activated, also stick ball to paddle once new velocity vectors were calculated
         Ball->Stuck = Ball->Sticky;
+        // sparks fly off the paddle where the ball hit it
+        Particles->Emit(PaddleSparks, glm::vec2(Ball->Position.x, Player->Position.y), ScaledParticles(12), glm::vec2(0.0f),
+                        glm::vec3(1.0f, 0.8f, 0.4f), glm::vec2(Ball->Radius * 2.0f, 0.0f));
 
         SoundEngine->play2D("resources/audio/bleep.wav", false);
     }
@@ -9,6 +9,7 @@
 #include "GameLevel.h"
 #include "BallObject.h"
 #include "PowerUp.h"
+#include "PostProcessor.h"
 
 // Represents the current state of the game
 enum GameState
@@ -54,6 +55,17 @@ public:
     std::vector<PowerUp> PowerUps;
     unsigned int Level;
     int Lives;
+    // debug statistics overlay (toggled with F3)
+    bool ShowStats;
+    // simulate the ball trail on the GPU instead of the CPU (toggled with F4)
+    bool GpuParticles;
+    // draw the ball and powerup trails as ribbons instead of particles (toggled with F5)
+    bool RibbonTrails;
+    // run the scene through a bloom pass (toggled with F6)
+    bool Bloom;
+    // anti-aliasing of the scene (picked on the command line, cycled with F7)
+    AntiAliasing AA;
+    float FrameTime;
     // constructor/destructor
     Game(unsigned int width, unsigned int height);
     ~Game();
@@ -65,6 +77,16 @@ public:
     void Update(float dt);
 
     void Render();
+    // bracket everything a frame does before the buffer swap, so the quality governor can time it
+    void BeginFrame();
+
+    void EndFrame();
+    // the framebuffer changed size (window resize, or a screen with another DPI); the game keeps its logical size
+    void Resize(unsigned int width, unsigned int height);
+    // whether the screen only changes on input (menu and win screens), so the loop can wait for events
+    bool StaticScreen() const;
+
+    std::string StatsText();
 
     void DoCollisions();
 
@@ -75,6 +97,19 @@ public:
     // powerups
     void SpawnPowerUps(GameObject& block);
     void UpdatePowerUps(float dt);
+
+private:
+    // applies the quality governor's knobs at the current framebuffer size
+    void applyQuality();
+    // what the cached static screen was rendered for
+    bool screenCached;
+    GameState cachedState;
+    unsigned int cachedLevel;
+    int cachedLives;
+    // renders the scene through the postprocessor, into the static screen cache if toCache is set
+    void renderScene(bool toCache);
+    // queues a line of text for the overlay pass
+    void queueText(std::string text, float x, float y, float scale, glm::vec3 color = glm::vec3(1.0f));
 };
 
 
@@ -3,15 +3,39 @@
 //
 
 #include "GameLevel.h"
+#include "GLStateCache.h"
 
+#include <algorithm>
+#include <cstddef>
 #include <fstream>
 #include <sstream>
 
 
+GameLevel::GameLevel(const GameLevel &other)
+    : Bricks(other.Bricks)
+{
+}
+
+GameLevel &GameLevel::operator=(const GameLevel &other)
+{
+    if (this != &other)
+    {
+        this->releaseMesh();
+        this->Bricks = other.Bricks;
+    }
+    return *this;
+}
+
+GameLevel::~GameLevel()
+{
+    this->releaseMesh();
+}
+
 void GameLevel::Load(const char *file, unsigned int levelWidth, unsigned int levelHeight)
 {
     // clear old data
     this->Bricks.clear();
+    this->meshDirty = true;
     // load from file
     unsigned int tileCode;
     GameLevel level;
@@ -40,6 +64,27 @@ void GameLevel::Draw(SpriteRenderer &renderer)
             tile.Draw(renderer);
 }
 
+void GameLevel::Draw(SpriteBatch &batch)
+{
+    if (this->meshDirty)
+        this->buildMesh(batch);
+    for (const BrickRange &range : this->ranges)
+        batch.DrawInstances(range.VAO, range.TextureID, range.Count);
+}
+
+void GameLevel::DestroyBrick(unsigned int index)
+{
+    this->Bricks[index].Destroyed = true;
+    if (this->meshDirty)
+        return; // not uploaded yet, the next build skips it anyway
+    // collapse the brick's instance to a zero-sized quad instead of rebuilding the buffer
+    glm::vec4 rect(this->Bricks[index].Position, 0.0f, 0.0f);
+    GLStateCache::BindBuffer(GL_ARRAY_BUFFER, this->instanceVBO);
+    glBufferSubData(GL_ARRAY_BUFFER, this->brickSlots[index] * sizeof(SpriteInstance) + offsetof(SpriteInstance, Rect),
+                    sizeof(rect), &rect);
+    GLStateCache::BindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
 bool GameLevel::IsCompleted()
 {
     for (GameObject &tile : this->Bricks)
@@ -48,6 +93,55 @@ bool GameLevel::IsCompleted()
     return true;
 }
 
+void GameLevel::buildMesh(SpriteBatch &batch)
+{
+    this->releaseMesh();
+    // order instances by texture so each texture is a single contiguous range
+    std::vector<unsigned int> order(this->Bricks.size());
+    for (unsigned int i = 0; i < order.size(); ++i)
+        order[i] = i;
+    std::stable_sort(order.begin(), order.end(), [this](unsigned int a, unsigned int b)
+                     { return this->Bricks[a].Sprite.ID < this->Bricks[b].Sprite.ID; });
+    std::vector<SpriteInstance> instances(this->Bricks.size());
+    this->brickSlots.resize(this->Bricks.size());
+    for (unsigned int slot = 0; slot < order.size(); ++slot)
+    {
+        const GameObject &brick = this->Bricks[order[slot]];
+        // destroyed bricks keep their slot but have no size
+        glm::vec2 size = brick.Destroyed ? glm::vec2(0.0f) : brick.Size;
+        instances[slot] = { glm::vec4(brick.Position, size), brick.Rotation, glm::vec4(brick.Color, 1.0f), brick.Sprite.UV };
+        this->brickSlots[order[slot]] = slot;
+    }
+    glGenBuffers(1, &this->instanceVBO);
+    GLStateCache::BindBuffer(GL_ARRAY_BUFFER, this->instanceVBO);
+    glBufferData(GL_ARRAY_BUFFER, instances.size() * sizeof(SpriteInstance), instances.data(), GL_STATIC_DRAW);
+    GLStateCache::BindBuffer(GL_ARRAY_BUFFER, 0);
+    // one vertex array per texture run (GL 3.3 has no base instance)
+    unsigned int first = 0;
+    while (first < order.size())
+    {
+        unsigned int textureID = this->Bricks[order[first]].Sprite.ID;
+        unsigned int last = first + 1;
+        while (last < order.size() && this->Bricks[order[last]].Sprite.ID == textureID)
+            ++last;
+        unsigned int VAO = batch.CreateInstanceArray(this->instanceVBO, first * sizeof(SpriteInstance));
+        this->ranges.push_back({ textureID, VAO, first, last - first });
+        first = last;
+    }
+    this->meshDirty = false;
+}
+
+void GameLevel::releaseMesh()
+{
+    for (const BrickRange &range : this->ranges)
+        GLStateCache::DeleteVertexArray(range.VAO);
+    this->ranges.clear();
+    if (this->instanceVBO != 0)
+        GLStateCache::DeleteBuffer(this->instanceVBO);
+    this->instanceVBO = 0;
+    this->meshDirty = true;
+}
+
 void GameLevel::init(std::vector<std::vector<unsigned int>> tileData, unsigned int levelWidth, unsigned int levelHeight)
 {
     // calculate dimensions
@@ -12,6 +12,7 @@
 
 #include "GameObject.h"
 #include "SpriteRenderer.h"
+#include "SpriteBatch.h"
 #include "ResourceManager.h"
 
 
@@ -22,15 +23,38 @@ class GameLevel
 public:
     // level state
     std::vector<GameObject> Bricks;
-    // constructor
+    // constructor/destructor; copies share no GPU state and rebuild their own brick mesh
     GameLevel() = default;
+    GameLevel(const GameLevel &other);
+    GameLevel &operator=(const GameLevel &other);
+    ~GameLevel();
     // loads level from file
     void Load(const char *file, unsigned int levelWidth, unsigned int levelHeight);
     // render level
     void Draw(SpriteRenderer &renderer);
+    // render level from its retained brick mesh using the batch's shader (one draw call per brick texture)
+    void Draw(SpriteBatch &batch);
+    // marks a brick as destroyed and removes it from the brick mesh
+    void DestroyBrick(unsigned int index);
     // check if the level is completed (all non-solid tiles are destroyed)
     bool IsCompleted();
 private:
+    // a run of brick instances sharing one texture
+    struct BrickRange
+    {
+        unsigned int TextureID;
+        unsigned int VAO; // instance attributes start at this range's first instance
+        unsigned int First, Count;
+    };
+    // retained brick mesh, built lazily on the first Draw after Load
+    unsigned int instanceVBO = 0;
+    std::vector<BrickRange> ranges;
+    std::vector<unsigned int> brickSlots; // instance slot of each brick
+    bool meshDirty = true;
+    // (re)builds the instance buffer from the current bricks
+    void buildMesh(SpriteBatch &batch);
+    // releases the brick mesh's vertex arrays and buffer
+    void releaseMesh();
     // initialize level from tile data
     void init(std::vector<std::vector<unsigned int>> tileData, unsigned int levelWidth, unsigned int levelHeight);
 };
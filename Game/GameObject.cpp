@@ -13,4 +13,9 @@ GameObject::GameObject(glm::vec2 pos, glm::vec2 size, Texture2D sprite, glm::vec
 void GameObject::Draw(SpriteRenderer &renderer)
 {
     renderer.DrawSprite(this->Sprite, this->Position, this->Size, this->Rotation, this->Color);
+}
+
+void GameObject::Draw(SpriteBatch &batch)
+{
+    batch.Submit(this->Sprite, this->Position, this->Size, this->Rotation, this->Color);
 }
\ No newline at end of file
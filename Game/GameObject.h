@@ -12,6 +12,7 @@
 
 #include "Texture2D.h"
 #include "SpriteRenderer.h"
+#include "SpriteBatch.h"
 
 
 // Container object for holding all state relevant for a single
@@ -34,6 +35,8 @@ public:
     GameObject(glm::vec2 pos, glm::vec2 size, Texture2D sprite, glm::vec3 color = glm::vec3(1.0f), glm::vec2 velocity = glm::vec2(0.0f, 0.0f));
     // draw sprite
     virtual void Draw(SpriteRenderer &renderer);
+    // queue sprite into a batch
+    virtual void Draw(SpriteBatch &batch);
 };
 
 
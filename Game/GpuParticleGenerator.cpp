@@ -0,0 +1,160 @@
+#include "GpuParticleGenerator.h"
+#include "GLStateCache.h"
+#include "Random.h"
+
+#include <algorithm>
+#include <cstddef>
+
+// uniform handles
+static constexpr uint32_t DELTA_TIME = UniformId("deltaTime");
+static constexpr uint32_t UV_RECT = UniformId("uvRect");
+
+// seconds a particle lives
+static const float PARTICLE_LIFE = 1.0f;
+
+
+GpuParticleGenerator::GpuParticleGenerator(Shader updateShader, Shader shader, Texture2D texture, unsigned int amount)
+    : amount(amount), cursor(0), current(0), remaining(0.0f), updateShader(updateShader), shader(shader), texture(texture)
+{
+    this->init();
+}
+
+GpuParticleGenerator::~GpuParticleGenerator()
+{
+    for (unsigned int i = 0; i < 2; ++i)
+    {
+        GLStateCache::DeleteVertexArray(this->updateVAOs[i]);
+        GLStateCache::DeleteVertexArray(this->drawVAOs[i]);
+        GLStateCache::DeleteBuffer(this->buffers[i]);
+    }
+    GLStateCache::DeleteBuffer(this->quadVBO);
+}
+
+void GpuParticleGenerator::Update(float dt, GameObject &object, unsigned int newParticles, glm::vec2 offset)
+{
+    // spawn new particles on the CPU, same distribution (and draws) as ParticleSystem's trail emitter
+    this->randoms.resize(newParticles * 2);
+    Random::Stream(RANDOM_PARTICLES).Fill(this->randoms.data(), newParticles * 2);
+    for (unsigned int i = 0; i < newParticles; ++i)
+    {
+        float random = this->randoms[i * 2] * 10.0f - 5.0f;
+        float rColor = 0.5f + this->randoms[i * 2 + 1];
+        GpuParticle particle;
+        particle.PositionVelocity = glm::vec4(object.Position + random + offset, object.Velocity * 0.1f);
+        particle.Color = glm::vec4(rColor, rColor, rColor, 1.0f);
+        particle.LifeSize = glm::vec2(PARTICLE_LIFE, 10.0f);
+        this->spawns.push_back(particle);
+    }
+    if (newParticles > 0)
+        this->remaining = PARTICLE_LIFE;
+    else if (!this->Active())
+        return; // all slots are dead and stay so, nothing to advance
+    this->remaining -= dt;
+    this->uploadSpawns();
+    // advance every slot from the current buffer into the other one
+    unsigned int next = 1 - this->current;
+    this->updateShader.Use();
+    this->updateShader.SetFloat(DELTA_TIME, dt);
+    GLStateCache::BindVertexArray(this->updateVAOs[this->current]);
+    GLStateCache::BindBufferBase(GL_TRANSFORM_FEEDBACK_BUFFER, 0, this->buffers[next]);
+    glEnable(GL_RASTERIZER_DISCARD);
+    glBeginTransformFeedback(GL_POINTS);
+    glDrawArrays(GL_POINTS, 0, this->amount);
+    glEndTransformFeedback();
+    glDisable(GL_RASTERIZER_DISCARD);
+    this->current = next;
+}
+
+// render all particles (blend state is up to the caller, particles are meant to be drawn additively)
+void GpuParticleGenerator::Draw()
+{
+    this->shader.Use();
+    this->shader.SetVector4f(UV_RECT, this->texture.UV);
+    this->texture.Bind();
+    GLStateCache::BindVertexArray(this->drawVAOs[this->current]);
+    glDrawArraysInstanced(GL_TRIANGLES, 0, 6, this->amount);
+}
+
+void GpuParticleGenerator::init()
+{
+    // set up mesh and attribute properties
+    float particle_quad[] = {
+            0.0f, 1.0f, 0.0f, 1.0f,
+            1.0f, 0.0f, 1.0f, 0.0f,
+            0.0f, 0.0f, 0.0f, 0.0f,
+
+            0.0f, 1.0f, 0.0f, 1.0f,
+            1.0f, 1.0f, 1.0f, 1.0f,
+            1.0f, 0.0f, 1.0f, 0.0f
+    };
+    glGenBuffers(1, &this->quadVBO);
+    GLStateCache::BindBuffer(GL_ARRAY_BUFFER, this->quadVBO);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(particle_quad), particle_quad, GL_STATIC_DRAW);
+    // both state buffers start out with dead particles
+    std::vector<GpuParticle> dead(this->amount);
+    for (GpuParticle &particle : dead)
+    {
+        particle.PositionVelocity = glm::vec4(0.0f);
+        particle.Color = glm::vec4(1.0f);
+        particle.LifeSize = glm::vec2(0.0f);
+    }
+    glGenBuffers(2, this->buffers);
+    glGenVertexArrays(2, this->updateVAOs);
+    glGenVertexArrays(2, this->drawVAOs);
+    for (unsigned int i = 0; i < 2; ++i)
+    {
+        GLStateCache::BindBuffer(GL_ARRAY_BUFFER, this->buffers[i]);
+        glBufferData(GL_ARRAY_BUFFER, this->amount * sizeof(GpuParticle), dead.data(), GL_DYNAMIC_COPY);
+        // update pass: one point per particle
+        GLStateCache::BindVertexArray(this->updateVAOs[i]);
+        setParticleAttributes(0, 0);
+        // draw pass: the quad per vertex, the particle state per instance
+        GLStateCache::BindVertexArray(this->drawVAOs[i]);
+        setParticleAttributes(1, 1);
+        GLStateCache::BindBuffer(GL_ARRAY_BUFFER, this->quadVBO);
+        glEnableVertexAttribArray(0);
+        glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)0);
+    }
+    GLStateCache::BindBuffer(GL_ARRAY_BUFFER, 0);
+    GLStateCache::BindVertexArray(0);
+}
+
+void GpuParticleGenerator::uploadSpawns()
+{
+    if (this->spawns.empty())
+        return;
+    // only the newest amount spawns survive the frame anyway
+    unsigned int count = static_cast<unsigned int>(this->spawns.size());
+    unsigned int first = 0;
+    if (count > this->amount)
+    {
+        this->cursor = (this->cursor + count - this->amount) % this->amount;
+        first = count - this->amount;
+        count = this->amount;
+    }
+    GLStateCache::BindBuffer(GL_ARRAY_BUFFER, this->buffers[this->current]);
+    // at most two runs: up to the end of the buffer and from its start
+    while (count > 0)
+    {
+        unsigned int run = std::min(count, this->amount - this->cursor);
+        glBufferSubData(GL_ARRAY_BUFFER, this->cursor * sizeof(GpuParticle), run * sizeof(GpuParticle),
+                        &this->spawns[first]);
+        this->cursor = (this->cursor + run) % this->amount;
+        first += run;
+        count -= run;
+    }
+    this->spawns.clear();
+}
+
+void GpuParticleGenerator::setParticleAttributes(unsigned int first, unsigned int divisor)
+{
+    glEnableVertexAttribArray(first);
+    glVertexAttribPointer(first, 4, GL_FLOAT, GL_FALSE, sizeof(GpuParticle), (void*)offsetof(GpuParticle, PositionVelocity));
+    glVertexAttribDivisor(first, divisor);
+    glEnableVertexAttribArray(first + 1);
+    glVertexAttribPointer(first + 1, 4, GL_FLOAT, GL_FALSE, sizeof(GpuParticle), (void*)offsetof(GpuParticle, Color));
+    glVertexAttribDivisor(first + 1, divisor);
+    glEnableVertexAttribArray(first + 2);
+    glVertexAttribPointer(first + 2, 2, GL_FLOAT, GL_FALSE, sizeof(GpuParticle), (void*)offsetof(GpuParticle, LifeSize));
+    glVertexAttribDivisor(first + 2, divisor);
+}
@@ -0,0 +1,68 @@
+#ifndef PROJEKT1_GPUPARTICLEGENERATOR_H
+#define PROJEKT1_GPUPARTICLEGENERATOR_H
+
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "Shader.h"
+#include "Texture2D.h"
+#include "GameObject.h"
+
+
+// State of one particle as stored in the GPU buffers (and captured by transform feedback)
+struct GpuParticle
+{
+    glm::vec4 PositionVelocity; // <vec2 position, vec2 velocity>
+    glm::vec4 Color;
+    glm::vec2 LifeSize;         // <float life, float size>
+};
+
+
+// GpuParticleGenerator is a trail emitter (like EMITTER_TRAIL of
+// ParticleSystem) that keeps its particles on the GPU. The state lives
+// in two buffers that take turns as source and destination of a
+// transform feedback pass (particle_update.vs), so the CPU only uploads
+// the particles spawned each frame. Spawns go to the slots round-robin,
+// which replaces the oldest particle as all of them live equally long.
+// Once the last spawned particle has died, Update() skips the pass and
+// Active() tells the caller it can skip Draw() as well.
+class GpuParticleGenerator
+{
+public:
+    // constructor/destructor; updateShader is the transform feedback program, shader renders the particles
+    GpuParticleGenerator(Shader updateShader, Shader shader, Texture2D texture, unsigned int amount);
+    ~GpuParticleGenerator();
+    // spawns newParticles particles trailing object and advances all particles on the GPU
+    void Update(float dt, GameObject &object, unsigned int newParticles, glm::vec2 offset = glm::vec2(0.0f, 0.0f));
+    // renders all particles with one instanced draw call; expects premultiplied blending (GL_ONE, GL_ONE_MINUS_SRC_ALPHA), the output is additive
+    void Draw();
+    // whether any particle is still alive
+    bool Active() const { return this->remaining > 0.0f; }
+
+private:
+    // state
+    unsigned int amount;
+    unsigned int cursor;  // slot the next particle spawns in
+    unsigned int current; // buffer holding the latest state
+    float remaining;      // seconds until the last spawned particle has died
+    std::vector<GpuParticle> spawns; // spawned this frame, slots cursor - spawns.size() onwards
+    std::vector<float> randoms;      // scratch for the batched random draws of Update()
+    // render state
+    Shader updateShader, shader;
+    Texture2D texture;
+    unsigned int buffers[2], updateVAOs[2], drawVAOs[2];
+    unsigned int quadVBO;
+    // disable copying, the GL objects are owned
+    GpuParticleGenerator(const GpuParticleGenerator &) = delete;
+    GpuParticleGenerator &operator=(const GpuParticleGenerator &) = delete;
+    // initializes buffers and vertex attributes
+    void init();
+    // writes this frame's spawns into their slots of the current buffer
+    void uploadSpawns();
+    // points attribute locations first.. first+2 of the bound vertex array at the particle state in the bound buffer
+    static void setParticleAttributes(unsigned int first, unsigned int divisor);
+};
+
+
+#endif //PROJEKT1_GPUPARTICLEGENERATOR_H
@@ -3,8 +3,14 @@
 
 #include "game.h"
 #include "ResourceManager.h"
+#include "GLStateCache.h"
+#include "Random.h"
 
+#include <cerrno>
+#include <chrono>
+#include <cstdlib>
 #include <iostream>
+#include <string>
 
 // GLFW function declarations
 void framebuffer_size_callback(GLFWwindow* window, int width, int height);
@@ -14,6 +20,8 @@ void key_callback(GLFWwindow* window, int key, int scancode, int action, int mod
 const unsigned int SCREEN_WIDTH = 800;
 // The height of the screen
 const unsigned int SCREEN_HEIGHT = 600;
+// Longest time (in seconds) a static screen waits for input before redrawing anyway
+const double IDLE_TIMEOUT = 0.5;
 
 Game Breakout(SCREEN_WIDTH, SCREEN_HEIGHT);
 
@@ -42,15 +50,53 @@ int main(int argc, char *argv[])
     glfwSetKeyCallback(window, key_callback);
     glfwSetFramebufferSizeCallback(window, framebuffer_size_callback);
 
-    // OpenGL configuration
+    // OpenGL configuration; the framebuffer is larger than the window on HiDPI screens
     // --------------------
-    glViewport(0, 0, SCREEN_WIDTH, SCREEN_HEIGHT);
-    glEnable(GL_BLEND);
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    int framebufferWidth, framebufferHeight;
+    glfwGetFramebufferSize(window, &framebufferWidth, &framebufferHeight);
+    glViewport(0, 0, framebufferWidth, framebufferHeight);
+    GLStateCache::SetBlend(true);
+    GLStateCache::BlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA); // premultiplied alpha
+
+    // command line: --seed=<number> replays a session, --aa=<off|msaa2|msaa4|msaa8|fxaa> picks the anti-aliasing;
+    // anything invalid is reported and ignored
+    // ---------------------------------------------------------------------------
+    uint64_t seed = static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string argument = argv[i];
+        if (argument.rfind("--seed=", 0) == 0)
+        {
+            const char *value = argv[i] + 7;
+            char *end;
+            errno = 0;
+            uint64_t parsed = std::strtoull(value, &end, 10);
+            if (end != value && *end == '\0' && errno == 0 && value[0] != '-')
+                seed = parsed;
+            else
+                std::cout << "ERROR::ARGUMENTS: Invalid seed: " << value << std::endl;
+        }
+        else if (argument.rfind("--aa=", 0) == 0)
+        {
+            std::string value = argument.substr(5);
+            int mode = 0;
+            while (mode < AA_MODES && value != PostProcessor::AntiAliasingName(static_cast<AntiAliasing>(mode)))
+                ++mode;
+            if (mode < AA_MODES)
+                Breakout.AA = static_cast<AntiAliasing>(mode);
+            else
+                std::cout << "ERROR::ARGUMENTS: Unknown anti-aliasing mode: " << value << std::endl;
+        }
+        else
+            std::cout << "ERROR::ARGUMENTS: Unknown argument: " << argument << std::endl;
+    }
+    Random::Seed(seed);
+    std::cout << "Random seed: " << seed << " (replay with --seed=" << seed << ")" << std::endl;
 
     // initialize game
     // ---------------
     Breakout.Init();
+    Breakout.Resize(framebufferWidth, framebufferHeight);
 
     // deltaTime variables
     // -------------------
@@ -59,12 +105,20 @@ int main(int argc, char *argv[])
 
     while (!glfwWindowShouldClose(window))
     {
+        // static screens only change on input, so sleep until some arrives
+        // (the time spent waiting doesn't count as frame time)
+        if (Breakout.StaticScreen())
+        {
+            glfwWaitEventsTimeout(IDLE_TIMEOUT);
+            lastFrame = glfwGetTime();
+        }
         // calculate delta time
         // --------------------
         float currentFrame = glfwGetTime();
         deltaTime = currentFrame - lastFrame;
         lastFrame = currentFrame;
         glfwPollEvents();
+        Breakout.BeginFrame();
 
         // projection matrix
         glm::mat4 projection = glm::ortho(0.0f, 800.0f, 600.0f, 0.0f, -1.0f, 1.0f);
@@ -82,6 +136,7 @@ int main(int argc, char *argv[])
         glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
         glClear(GL_COLOR_BUFFER_BIT);
         Breakout.Render();
+        Breakout.EndFrame();
 
         glfwSwapBuffers(window);
     }
@@ -116,5 +171,7 @@ void framebuffer_size_callback(GLFWwindow* window, int width, int height)
     // make sure the viewport matches the new window dimensions; note that width and
     // height will be significantly larger than specified on retina displays.
     glViewport(0, 0, width, height);
+    // and the game renders at the new size
+    Breakout.Resize(width, height);
 }
 
@@ -0,0 +1,139 @@
+#include "ParticleKernels.h"
+#include "ThreadPool.h"
+
+#include <algorithm>
+
+// pick the widest kernel the compiler targets; define PROJEKT1_NO_SIMD to force the scalar one
+#if !defined(PROJEKT1_NO_SIMD) && defined(__AVX2__)
+#define PARTICLE_KERNEL_AVX2
+#include <immintrin.h>
+#elif !defined(PROJEKT1_NO_SIMD) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define PARTICLE_KERNEL_SSE2
+#include <emmintrin.h>
+#endif
+
+
+// alpha lost per second of life
+static const float FADE_RATE = 2.5f;
+
+
+void ParticleStreams::Resize(unsigned int count)
+{
+    this->PositionX.resize(count, 0.0f);
+    this->PositionY.resize(count, 0.0f);
+    this->VelocityX.resize(count, 0.0f);
+    this->VelocityY.resize(count, 0.0f);
+    this->Alpha.resize(count, 1.0f);
+    this->Life.resize(count, 0.0f);
+    this->Red.resize(count, 1.0f);
+    this->Green.resize(count, 1.0f);
+    this->Blue.resize(count, 1.0f);
+    this->Size.resize(count, 0.0f);
+    this->Emitter.resize(count, 0);
+}
+
+void ParticleStreams::Copy(unsigned int from, unsigned int to)
+{
+    this->PositionX[to] = this->PositionX[from];
+    this->PositionY[to] = this->PositionY[from];
+    this->VelocityX[to] = this->VelocityX[from];
+    this->VelocityY[to] = this->VelocityY[from];
+    this->Alpha[to] = this->Alpha[from];
+    this->Life[to] = this->Life[from];
+    this->Red[to] = this->Red[from];
+    this->Green[to] = this->Green[from];
+    this->Blue[to] = this->Blue[from];
+    this->Size[to] = this->Size[from];
+    this->Emitter[to] = this->Emitter[from];
+}
+
+void UpdateParticlesScalar(ParticleStreams &particles, unsigned int first, unsigned int last, float dt)
+{
+    float *x = particles.PositionX.data(), *y = particles.PositionY.data();
+    const float *vx = particles.VelocityX.data(), *vy = particles.VelocityY.data();
+    float *alpha = particles.Alpha.data(), *life = particles.Life.data();
+    float fade = dt * FADE_RATE;
+    for (unsigned int i = first; i < last; ++i)
+    {
+        life[i] -= dt; // reduce life
+        if (life[i] > 0.0f)
+        {	// particle is alive, thus update
+            x[i] -= vx[i] * dt;
+            y[i] -= vy[i] * dt;
+            alpha[i] -= fade;
+        }
+    }
+}
+
+void UpdateParticles(ParticleStreams &particles, unsigned int first, unsigned int last, float dt)
+{
+    unsigned int i = first;
+#if defined(PARTICLE_KERNEL_AVX2) || defined(PARTICLE_KERNEL_SSE2)
+    float *x = particles.PositionX.data(), *y = particles.PositionY.data();
+    const float *vx = particles.VelocityX.data(), *vy = particles.VelocityY.data();
+    float *alpha = particles.Alpha.data(), *life = particles.Life.data();
+#endif
+    // same operations as the scalar loop, with the branch turned into a blend on the "alive" mask
+#if defined(PARTICLE_KERNEL_AVX2)
+    const __m256 delta = _mm256_set1_ps(dt), fade = _mm256_set1_ps(dt * FADE_RATE), zero = _mm256_setzero_ps();
+    for (; i + 8 <= last; i += 8)
+    {
+        __m256 l = _mm256_sub_ps(_mm256_loadu_ps(life + i), delta);
+        _mm256_storeu_ps(life + i, l);
+        __m256 alive = _mm256_cmp_ps(l, zero, _CMP_GT_OQ);
+        __m256 px = _mm256_loadu_ps(x + i), py = _mm256_loadu_ps(y + i), a = _mm256_loadu_ps(alpha + i);
+        px = _mm256_blendv_ps(px, _mm256_sub_ps(px, _mm256_mul_ps(_mm256_loadu_ps(vx + i), delta)), alive);
+        py = _mm256_blendv_ps(py, _mm256_sub_ps(py, _mm256_mul_ps(_mm256_loadu_ps(vy + i), delta)), alive);
+        a = _mm256_blendv_ps(a, _mm256_sub_ps(a, fade), alive);
+        _mm256_storeu_ps(x + i, px);
+        _mm256_storeu_ps(y + i, py);
+        _mm256_storeu_ps(alpha + i, a);
+    }
+#elif defined(PARTICLE_KERNEL_SSE2)
+    const __m128 delta = _mm_set1_ps(dt), fade = _mm_set1_ps(dt * FADE_RATE), zero = _mm_setzero_ps();
+    for (; i + 4 <= last; i += 4)
+    {
+        __m128 l = _mm_sub_ps(_mm_loadu_ps(life + i), delta);
+        _mm_storeu_ps(life + i, l);
+        __m128 alive = _mm_cmpgt_ps(l, zero);
+        __m128 px = _mm_loadu_ps(x + i), py = _mm_loadu_ps(y + i), a = _mm_loadu_ps(alpha + i);
+        // SSE2 has no blend instruction: (alive & updated) | (~alive & old)
+        __m128 nx = _mm_sub_ps(px, _mm_mul_ps(_mm_loadu_ps(vx + i), delta));
+        __m128 ny = _mm_sub_ps(py, _mm_mul_ps(_mm_loadu_ps(vy + i), delta));
+        __m128 na = _mm_sub_ps(a, fade);
+        _mm_storeu_ps(x + i, _mm_or_ps(_mm_and_ps(alive, nx), _mm_andnot_ps(alive, px)));
+        _mm_storeu_ps(y + i, _mm_or_ps(_mm_and_ps(alive, ny), _mm_andnot_ps(alive, py)));
+        _mm_storeu_ps(alpha + i, _mm_or_ps(_mm_and_ps(alive, na), _mm_andnot_ps(alive, a)));
+    }
+#endif
+    // remaining particles (all of them without SIMD)
+    UpdateParticlesScalar(particles, i, last, dt);
+}
+
+void UpdateParticlesParallel(ParticleStreams &particles, unsigned int first, unsigned int last, float dt,
+                             ThreadPool &pool)
+{
+    if (first >= last)
+        return;
+    // chunks are cut at multiples of PARTICLE_CHUNK from the (aligned) start of the streams, so no two
+    // threads ever write the same cache line; only the first and last chunk can be partial
+    unsigned int base = first - first % PARTICLE_CHUNK;
+    unsigned int chunks = (last - base + PARTICLE_CHUNK - 1) / PARTICLE_CHUNK;
+    pool.Run(chunks, [&particles, first, last, dt, base](unsigned int chunk)
+    {
+        unsigned int begin = std::max(first, base + chunk * PARTICLE_CHUNK);
+        unsigned int end = std::min(last, base + (chunk + 1) * PARTICLE_CHUNK);
+        UpdateParticles(particles, begin, end, dt);
+    });
+}
+
+const char *ParticleKernelName()
+{
+#if defined(PARTICLE_KERNEL_AVX2)
+    return "AVX2";
+#elif defined(PARTICLE_KERNEL_SSE2)
+    return "SSE2";
+#else
+    return "scalar";
+#endif
+}
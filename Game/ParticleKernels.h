@@ -0,0 +1,76 @@
+#ifndef PROJEKT1_PARTICLEKERNELS_H
+#define PROJEKT1_PARTICLEKERNELS_H
+
+#include <cstddef>
+#include <new>
+#include <vector>
+
+class ThreadPool;
+
+// size of a cache line, particle streams start on one so that update chunks never share a line
+const std::size_t CACHE_LINE_SIZE = 64;
+
+// allocator handing out cache-line-aligned memory, for the particle streams
+template <typename T>
+struct CacheAlignedAllocator
+{
+    typedef T value_type;
+    CacheAlignedAllocator() = default;
+    template <typename U>
+    CacheAlignedAllocator(const CacheAlignedAllocator<U> &) {}
+    T *allocate(std::size_t n)
+    {
+        return static_cast<T *>(::operator new(n * sizeof(T), std::align_val_t(CACHE_LINE_SIZE)));
+    }
+    void deallocate(T *p, std::size_t)
+    {
+        ::operator delete(p, std::align_val_t(CACHE_LINE_SIZE));
+    }
+    template <typename U>
+    bool operator==(const CacheAlignedAllocator<U> &) const { return true; }
+    template <typename U>
+    bool operator!=(const CacheAlignedAllocator<U> &) const { return false; }
+};
+
+// one component of all particles
+typedef std::vector<float, CacheAlignedAllocator<float>> ParticleStream;
+
+
+// Particle state stored as a structure of arrays: one contiguous stream
+// per component, so the update kernel can process 4 (SSE2) or 8 (AVX2)
+// particles per instruction. The kernel only touches position, velocity,
+// alpha and life; the other streams are read when rendering.
+struct ParticleStreams
+{
+    ParticleStream PositionX, PositionY;
+    ParticleStream VelocityX, VelocityY;
+    ParticleStream Alpha, Life;
+    ParticleStream Red, Green, Blue, Size;
+    std::vector<unsigned short> Emitter; // owner of each particle
+    // resizes all streams, new particles are dead
+    void Resize(unsigned int count);
+    // copies particle from over particle to
+    void Copy(unsigned int from, unsigned int to);
+    // number of particles in the streams
+    unsigned int Count() const { return static_cast<unsigned int>(this->Life.size()); }
+};
+
+
+// advances particles [first, last) by dt: decays their life and, for the ones
+// still alive, integrates their position and fades their alpha. Uses the widest
+// kernel the build targets (see ParticleKernelName()), gives the same results as
+// UpdateParticlesScalar
+void UpdateParticles(ParticleStreams &particles, unsigned int first, unsigned int last, float dt);
+// plain C++ version of UpdateParticles, also used for the tail the SIMD kernels don't cover
+void UpdateParticlesScalar(ParticleStreams &particles, unsigned int first, unsigned int last, float dt);
+// UpdateParticles split into chunks of PARTICLE_CHUNK particles that run on the pool's
+// threads; chunk boundaries are cache-line aligned, the results don't depend on the thread count
+void UpdateParticlesParallel(ParticleStreams &particles, unsigned int first, unsigned int last, float dt,
+                             ThreadPool &pool);
+// particles per chunk of UpdateParticlesParallel, a multiple of the floats in a cache line
+const unsigned int PARTICLE_CHUNK = 4096;
+// name of the kernel UpdateParticles uses: "AVX2", "SSE2" or "scalar"
+const char *ParticleKernelName();
+
+
+#endif //PROJEKT1_PARTICLEKERNELS_H
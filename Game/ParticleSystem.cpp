@@ -0,0 +1,164 @@
+#include "ParticleSystem.h"
+#include "Random.h"
+
+#include <algorithm>
+
+
+ParticleSystem::ParticleSystem(Texture2D texture, unsigned int capacity, ParticleOverflow overflow)
+        : Overflow(overflow), Workers(nullptr), capacity(capacity), liveCount(0), texture(texture)
+{
+    // allocate the pool, all particles start out dead
+    this->particles.Resize(this->capacity);
+}
+
+unsigned int ParticleSystem::AddEmitter(const ParticleEmitter &emitter)
+{
+    this->emitters.push_back(emitter);
+    this->emitterLive.push_back(0);
+    return static_cast<unsigned int>(this->emitters.size() - 1);
+}
+
+void ParticleSystem::Emit(unsigned int emitter, glm::vec2 position, unsigned int count, glm::vec2 velocity,
+                          glm::vec3 color, glm::vec2 area)
+{
+    const ParticleEmitter &settings = this->emitters[emitter];
+    // draw the random numbers of all spawns in one batch: trails need a jitter and a shade,
+    // bursts and sparks an angle, a position (2), a speed and a shade
+    const unsigned int draws = settings.Shape == EMITTER_TRAIL ? 2 : 5;
+    this->randoms.resize(count * draws);
+    Random::Stream(RANDOM_PARTICLES).Fill(this->randoms.data(), count * draws);
+    for (unsigned int i = 0; i < count; ++i)
+    {
+        int index = this->allocateParticle(emitter);
+        if (index < 0)
+            return;
+        const float *random = &this->randoms[i * draws];
+        // particles move by -Velocity (see UpdateParticles), so store the negated direction of travel
+        glm::vec2 spawn, motion;
+        if (settings.Shape == EMITTER_TRAIL)
+        {
+            spawn = position + (random[0] * 10.0f - 5.0f);
+            motion = -velocity * 0.1f;
+        }
+        else if (settings.Shape == EMITTER_BURST)
+        {
+            float angle = random[0] * 6.2831853f;
+            spawn = position + area * glm::vec2(random[1], random[2]);
+            motion = glm::vec2(glm::cos(angle), glm::sin(angle)) * settings.Speed * (0.5f + 0.5f * random[3]);
+        }
+        else
+        {
+            // within 30 degrees of straight up
+            float angle = (random[0] - 0.5f) * 1.0471976f;
+            spawn = position + glm::vec2(area.x * random[1], 0.0f);
+            motion = glm::vec2(glm::sin(angle), -glm::cos(angle)) * settings.Speed * (0.5f + 0.5f * random[3]);
+        }
+        float shade = 0.5f + random[draws - 1];
+        this->particles.PositionX[index] = spawn.x;
+        this->particles.PositionY[index] = spawn.y;
+        this->particles.VelocityX[index] = -motion.x;
+        this->particles.VelocityY[index] = -motion.y;
+        this->particles.Alpha[index] = 1.0f;
+        this->particles.Life[index] = settings.Life;
+        this->particles.Red[index] = color.r * shade;
+        this->particles.Green[index] = color.g * shade;
+        this->particles.Blue[index] = color.b * shade;
+        this->particles.Size[index] = settings.Size;
+        this->particles.Emitter[index] = static_cast<unsigned short>(emitter);
+    }
+}
+
+void ParticleSystem::Update(float dt)
+{
+    // all emitters share the streams, so one kernel pass covers them all; small pools
+    // are done sooner than the workers would wake up
+    if (this->Workers && this->liveCount >= PARALLEL_THRESHOLD)
+        UpdateParticlesParallel(this->particles, 0, this->liveCount, dt, *this->Workers);
+    else
+        UpdateParticles(this->particles, 0, this->liveCount, dt);
+    this->removeDead();
+}
+
+void ParticleSystem::Draw(SpriteBatch &batch)
+{
+    for (unsigned int i = 0; i < this->liveCount; ++i)
+    {
+        // premultiply by the fade and leave alpha at 0, which makes the sprite additive
+        float fade = std::max(this->particles.Alpha[i], 0.0f);
+        glm::vec3 color(this->particles.Red[i], this->particles.Green[i], this->particles.Blue[i]);
+        batch.Submit(this->texture, glm::vec2(this->particles.PositionX[i], this->particles.PositionY[i]),
+                     glm::vec2(this->particles.Size[i]), 0.0f, color * fade, 0.0f);
+    }
+}
+
+void ParticleSystem::Clear()
+{
+    this->liveCount = 0;
+    std::fill(this->emitterLive.begin(), this->emitterLive.end(), 0u);
+}
+
+int ParticleSystem::allocateParticle(unsigned int emitter)
+{
+    // an emitter over its budget only ever replaces its own particles
+    if (this->emitterLive[emitter] >= this->emitters[emitter].Budget)
+    {
+        if (this->Overflow == OVERFLOW_DROP || this->emitterLive[emitter] == 0)
+            return -1;
+        return this->oldestParticle(emitter);
+    }
+    // a free slot is always right behind the live range
+    if (this->liveCount < this->capacity)
+    {
+        ++this->emitterLive[emitter];
+        return this->liveCount++;
+    }
+    if (this->Overflow == OVERFLOW_DROP)
+        return -1;
+    if (this->Overflow == OVERFLOW_GROW)
+    {
+        this->capacity = std::max(this->capacity * 2, 1u);
+        this->particles.Resize(this->capacity);
+        ++this->emitterLive[emitter];
+        return this->liveCount++;
+    }
+    // take over the oldest particle of any emitter
+    unsigned int index = this->oldestParticle(-1);
+    --this->emitterLive[this->particles.Emitter[index]];
+    ++this->emitterLive[emitter];
+    return index;
+}
+
+unsigned int ParticleSystem::oldestParticle(int emitter) const
+{
+    // this scan only happens when the pool or a budget is too small, size them for the common case
+    unsigned int oldest = 0;
+    float least = 0.0f;
+    bool found = false;
+    for (unsigned int i = 0; i < this->liveCount; ++i)
+    {
+        if (emitter >= 0 && this->particles.Emitter[i] != emitter)
+            continue;
+        if (!found || this->particles.Life[i] < least)
+        {
+            oldest = i;
+            least = this->particles.Life[i];
+            found = true;
+        }
+    }
+    return oldest;
+}
+
+void ParticleSystem::removeDead()
+{
+    unsigned int i = 0;
+    while (i < this->liveCount)
+    {
+        if (this->particles.Life[i] > 0.0f)
+            ++i;
+        else
+        {
+            --this->emitterLive[this->particles.Emitter[i]];
+            this->particles.Copy(--this->liveCount, i);
+        }
+    }
+}
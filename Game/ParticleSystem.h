@@ -0,0 +1,96 @@
+#ifndef PROJEKT1_PARTICLESYSTEM_H
+#define PROJEKT1_PARTICLESYSTEM_H
+
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "SpriteBatch.h"
+#include "Texture2D.h"
+#include "ParticleKernels.h"
+#include "ThreadPool.h"
+
+
+// What a ParticleSystem does when a particle is spawned while its pool
+// (or the emitter's budget) is full
+enum ParticleOverflow
+{
+    OVERFLOW_DROP,            // don't spawn the new particle
+    OVERFLOW_RECYCLE_OLDEST,  // replace the particle closest to dying
+    OVERFLOW_GROW             // double the pool (budgets stay as they are)
+};
+
+// How an emitter places new particles and sets them in motion
+enum EmitterShape
+{
+    EMITTER_TRAIL,  // jittered around the position, drifting against the given velocity
+    EMITTER_BURST,  // anywhere in the area, flying outwards from its center
+    EMITTER_SPARKS  // along the top edge of the area, flying upwards in a cone
+};
+
+// Settings of an emitter, see ParticleSystem::AddEmitter
+struct ParticleEmitter
+{
+    EmitterShape Shape;
+    unsigned int Budget; // maximum number of live particles of this emitter
+    float        Life;   // seconds a particle lives
+    float        Size;   // particle quad size in pixels
+    float        Speed;  // initial speed of burst and spark particles
+};
+
+
+// ParticleSystem owns one pool of particles that any number of
+// emitters spawn into. Emitters are referred to by the handle
+// AddEmitter() returns and only describe how particles are spawned;
+// all particles are updated in one pass and drawn as additive sprites
+// of a SpriteBatch no matter which emitter they came from.
+// Live particles are kept contiguous in [0, LiveCount()): spawning
+// appends and dying swaps the last live particle into the gap.
+// Given a thread pool, large particle counts are updated in parallel.
+class ParticleSystem
+{
+public:
+    // what happens to spawns once the pool or an emitter's budget is full
+    ParticleOverflow Overflow;
+    // pool to spread the update of PARALLEL_THRESHOLD or more live particles over, nullptr to stay on the calling thread
+    ThreadPool *Workers;
+    static const unsigned int PARALLEL_THRESHOLD = 16 * PARTICLE_CHUNK;
+    // constructor, capacity is the global cap on live particles
+    ParticleSystem(Texture2D texture, unsigned int capacity, ParticleOverflow overflow = OVERFLOW_RECYCLE_OLDEST);
+    // registers an emitter and returns its handle
+    unsigned int AddEmitter(const ParticleEmitter &emitter);
+    // spawns count particles from the given emitter; velocity is only used by trails,
+    // area is the region bursts fill and the edge sparks fly off, color tints the particles
+    void Emit(unsigned int emitter, glm::vec2 position, unsigned int count, glm::vec2 velocity = glm::vec2(0.0f),
+              glm::vec3 color = glm::vec3(1.0f), glm::vec2 area = glm::vec2(0.0f));
+    // updates all live particles
+    void Update(float dt);
+    // queues all live particles into batch as additive sprites, so they share a draw call with the batch's other
+    // sprites on the same texture (atlas page)
+    void Draw(SpriteBatch &batch);
+    // kills all particles
+    void Clear();
+    // number of live particles (of one emitter) / size of the pool
+    unsigned int LiveCount() const { return this->liveCount; }
+    unsigned int LiveCount(unsigned int emitter) const { return this->emitterLive[emitter]; }
+    unsigned int Capacity() const { return this->capacity; }
+
+private:
+    // state
+    ParticleStreams particles;
+    unsigned int capacity, liveCount;
+    std::vector<ParticleEmitter> emitters;
+    std::vector<unsigned int> emitterLive; // live particles per emitter
+    std::vector<float> randoms;            // scratch for the batched random draws of Emit()
+    // render state
+    Texture2D texture;
+    // returns the index to spawn a particle of the given emitter at according to the overflow policy, or -1 to drop the spawn
+    int allocateParticle(unsigned int emitter);
+    // returns the live particle (of the given emitter, or of any if emitter is -1) with the least life left
+    unsigned int oldestParticle(int emitter) const;
+    // swap-removes the particles that died, keeping the live ones in [0, liveCount)
+    void removeDead();
+};
+
+
+#endif //PROJEKT1_PARTICLESYSTEM_H
@@ -3,89 +3,231 @@
 //
 
 #include "PostProcessor.h"
+#include "GLStateCache.h"
+#include "ResourceManager.h"
 
+#include <algorithm>
+#include <cmath>
 #include <iostream>
+#include <vector>
 
-PostProcessor::PostProcessor(Shader shader, unsigned int width, unsigned int height)
-    : PostProcessingShader(shader), Texture(), Width(width), Height(height), Confuse(false), Chaos(false), Shake(false)
+// bits of the post-processing shader permutations, each one is a define of post_processing.vs/.frag
+static const unsigned int POST_CHAOS = 1, POST_CONFUSE = 2, POST_SHAKE = 4, POST_REDUCED = 8, POST_FXAA = 16;
+
+// samples and names of the anti-aliasing modes, indexed by AntiAliasing
+static const unsigned int AA_SAMPLES[AA_MODES] = { 0, 2, 4, 8, 0 };
+static const char *const AA_NAMES[AA_MODES] = { "off", "msaa2", "msaa4", "msaa8", "fxaa" };
+
+// uniform handles of the chain passes (post_chain.frag)
+static constexpr uint32_t TEXEL_SIZE = UniformId("texelSize");
+static constexpr uint32_t DIRECTION = UniformId("direction");
+static constexpr uint32_t RADIUS = UniformId("radius");
+static constexpr uint32_t SIGMA = UniformId("sigma");
+static constexpr uint32_t THRESHOLD = UniformId("threshold");
+static constexpr uint32_t INTENSITY = UniformId("intensity");
+
+// largest blur radius in pixels; pairs of texels share a bilinear fetch, so a side needs radius / 2 fetches
+static const int BLUR_MAX_RADIUS = 32;
+// most mips a bloom pass goes down
+static const unsigned int BLOOM_MAX_LEVELS = 8;
+
+// whether the back buffer of the default framebuffer has the RGBA8 format of the scene buffer
+static bool defaultFramebufferIsRGBA8()
+{
+    GLint red = 0, green = 0, blue = 0, alpha = 0, type = 0, encoding = 0;
+    GLStateCache::BindFramebuffer(GL_FRAMEBUFFER, 0);
+    glGetFramebufferAttachmentParameteriv(GL_FRAMEBUFFER, GL_BACK_LEFT, GL_FRAMEBUFFER_ATTACHMENT_RED_SIZE, &red);
+    glGetFramebufferAttachmentParameteriv(GL_FRAMEBUFFER, GL_BACK_LEFT, GL_FRAMEBUFFER_ATTACHMENT_GREEN_SIZE, &green);
+    glGetFramebufferAttachmentParameteriv(GL_FRAMEBUFFER, GL_BACK_LEFT, GL_FRAMEBUFFER_ATTACHMENT_BLUE_SIZE, &blue);
+    glGetFramebufferAttachmentParameteriv(GL_FRAMEBUFFER, GL_BACK_LEFT, GL_FRAMEBUFFER_ATTACHMENT_ALPHA_SIZE, &alpha);
+    glGetFramebufferAttachmentParameteriv(GL_FRAMEBUFFER, GL_BACK_LEFT, GL_FRAMEBUFFER_ATTACHMENT_COMPONENT_TYPE, &type);
+    glGetFramebufferAttachmentParameteriv(GL_FRAMEBUFFER, GL_BACK_LEFT, GL_FRAMEBUFFER_ATTACHMENT_COLOR_ENCODING,
+                                          &encoding);
+    return red == 8 && green == 8 && blue == 8 && alpha == 8 && type == GL_UNSIGNED_NORMALIZED && encoding == GL_LINEAR;
+}
+
+PostProcessor::PostProcessor(std::string shader, std::string chainShader, unsigned int width, unsigned int height,
+                             unsigned int samples)
+    : Texture(), Width(width), Height(height), OutputWidth(width), OutputHeight(height), RenderScale(1.0f), Samples(0), AA(AA_MSAA_4X), Confuse(false), Chaos(false), Shake(false),
+      Quality(EFFECTS_FULL), ShakeBlur(2.0f), direct(false), screenRGBA8(defaultFramebufferIsRGBA8())
 {
     // initialize renderbuffer/framebuffer object
     glGenFramebuffers(1, &this->MSFBO);
     glGenFramebuffers(1, &this->FBO);
     glGenRenderbuffers(1, &this->RBO);
     // initialize renderbuffer storage with a multisampled color buffer (don't need a depth/stencil buffer)
-    glBindFramebuffer(GL_FRAMEBUFFER, this->MSFBO);
-    glBindRenderbuffer(GL_RENDERBUFFER, this->RBO);
-    glRenderbufferStorageMultisample(GL_RENDERBUFFER, 4, GL_RGB, width, height); // allocate storage for render buffer object
-    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, this->RBO); // attach MS render buffer object to framebuffer
-    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
-        std::cout << "ERROR::POSTPROCESSOR: Failed to initialize MSFBO" << std::endl;
-    // also initialize the FBO/texture to blit multisampled color-buffer to; used for shader operations (for postprocessing effects)
-    glBindFramebuffer(GL_FRAMEBUFFER, this->FBO);
-    this->Texture.Generate(width, height, NULL);
+    this->SetSamples(samples);
+    // also initialize the FBO/texture to blit multisampled color-buffer to; used for shader operations (for postprocessing effects).
+    // All color buffers are RGBA8 like the usual default framebuffer, GL 3.3 only resolves between identical formats
+    GLStateCache::BindFramebuffer(GL_FRAMEBUFFER, this->FBO);
+    this->Texture.Internal_Format = GL_RGBA8;
+    this->Texture.Generate(this->Width, this->Height, NULL);
     glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, this->Texture.ID, 0); // attach texture to framebuffer as its color attachment
     if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
         std::cout << "ERROR::POSTPROCESSOR: Failed to initialize FBO" << std::endl;
-    glBindFramebuffer(GL_FRAMEBUFFER, 0);
-    // initialize render data and uniforms
+    // and the FBO/texture static screens are cached in
+    glGenFramebuffers(1, &this->cacheFBO);
+    GLStateCache::BindFramebuffer(GL_FRAMEBUFFER, this->cacheFBO);
+    this->cache.Internal_Format = GL_RGBA8;
+    this->cache.Generate(this->OutputWidth, this->OutputHeight, NULL);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, this->cache.ID, 0);
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+        std::cout << "ERROR::POSTPROCESSOR: Failed to initialize cache FBO" << std::endl;
+    GLStateCache::BindFramebuffer(GL_FRAMEBUFFER, 0);
+    // initialize render data
     this->initRenderData();
-    this->PostProcessingShader.SetInteger("scene", 0, true);
-    float offset = 1.0f / 300.0f;
-    float offsets[9][2] = {
-        { -offset,  offset  },  // top-left
-        {  0.0f,    offset  },  // top-center
-        {  offset,  offset  },  // top-right
-        { -offset,  0.0f    },  // center-left
-        {  0.0f,    0.0f    },  // center-center
-        {  offset,  0.0f    },  // center - right
-        { -offset, -offset  },  // bottom-left
-        {  0.0f,   -offset  },  // bottom-center
-        {  offset, -offset  }   // bottom-right
-    };
-    glUniform2fv(glGetUniformLocation(this->PostProcessingShader.ID, "offsets"), 9, (float*)offsets);
-    int edge_kernel[9] = {
-        -1, -1, -1,
-        -1,  8, -1,
-        -1, -1, -1
-    };
-    glUniform1iv(glGetUniformLocation(this->PostProcessingShader.ID, "edge_kernel"), 9, edge_kernel);
-    float blur_kernel[9] = {
-        1.0f / 16.0f, 2.0f / 16.0f, 1.0f / 16.0f,
-        2.0f / 16.0f, 4.0f / 16.0f, 2.0f / 16.0f,
-        1.0f / 16.0f, 2.0f / 16.0f, 1.0f / 16.0f
-    };
-    glUniform1fv(glGetUniformLocation(this->PostProcessingShader.ID, "blur_kernel"), 9, blur_kernel);
+    // compile every permutation now rather than hitching the frame an effect first turns on;
+    // bits an effect set ignores map to an equal define list, so ResourceManager only builds those once
+    for (unsigned int bits = 0; bits < POST_VARIANTS; ++bits)
+    {
+        std::vector<std::string> defines;
+        if (bits & POST_CHAOS)
+            defines.push_back("CHAOS");
+        else if (bits & POST_CONFUSE)
+            defines.push_back("CONFUSE"); // chaos overrides confuse
+        if (bits & POST_SHAKE)
+            defines.push_back("SHAKE");
+        if ((bits & POST_REDUCED) && (bits & POST_CHAOS))
+            defines.push_back("REDUCED_EFFECTS"); // only changes the chaos kernel
+        if ((bits & POST_FXAA) && !(bits & POST_CHAOS))
+            defines.push_back("FXAA"); // chaos only keeps the edges
+        this->variants[bits] = ResourceManager::GetShaderVariant(shader, defines);
+        this->variants[bits].SetInteger("scene", 0, true);
+    }
+    // and the passes of the effect chain
+    this->blurShader = ResourceManager::GetShaderVariant(chainShader, { "BLUR" });
+    this->brightShader = ResourceManager::GetShaderVariant(chainShader, { "DOWNSAMPLE", "BRIGHT_PASS" });
+    this->downsampleShader = ResourceManager::GetShaderVariant(chainShader, { "DOWNSAMPLE" });
+    this->upsampleShader = ResourceManager::GetShaderVariant(chainShader, { "UPSAMPLE" });
+    this->edgeShader = ResourceManager::GetShaderVariant(chainShader, { "EDGE" });
+    this->invertShader = ResourceManager::GetShaderVariant(chainShader, { "INVERT" });
+    for (Shader *pass : { &this->blurShader, &this->brightShader, &this->downsampleShader, &this->upsampleShader,
+                          &this->edgeShader, &this->invertShader })
+        pass->SetInteger("source", 0, true);
+}
+
+void PostProcessor::SetSamples(unsigned int samples)
+{
+    int maxSamples;
+    glGetIntegerv(GL_MAX_SAMPLES, &maxSamples);
+    this->Samples = std::min(samples, static_cast<unsigned int>(maxSamples));
+    GLStateCache::BindFramebuffer(GL_FRAMEBUFFER, this->MSFBO);
+    glBindRenderbuffer(GL_RENDERBUFFER, this->RBO);
+    glRenderbufferStorageMultisample(GL_RENDERBUFFER, this->Samples, GL_RGBA8, this->Width, this->Height); // allocate storage for render buffer object
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, this->RBO); // attach MS render buffer object to framebuffer
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+        std::cout << "ERROR::POSTPROCESSOR: Failed to initialize MSFBO" << std::endl;
+    GLStateCache::BindFramebuffer(GL_FRAMEBUFFER, 0);
 }
 
-void PostProcessor::BeginRender() const
+void PostProcessor::SetAntiAliasing(AntiAliasing mode)
 {
-    glBindFramebuffer(GL_FRAMEBUFFER, this->MSFBO);
+    this->AA = mode;
+    this->SetSamples(AA_SAMPLES[mode]);
+}
+
+unsigned int PostProcessor::AntiAliasingSamples(AntiAliasing mode)
+{
+    return AA_SAMPLES[mode];
+}
+
+const char *PostProcessor::AntiAliasingName(AntiAliasing mode)
+{
+    return AA_NAMES[mode];
+}
+
+void PostProcessor::Resize(unsigned int width, unsigned int height)
+{
+    if (width == 0 || height == 0 || (width == this->OutputWidth && height == this->OutputHeight))
+        return; // minimized, or nothing changed
+    this->OutputWidth = width;
+    this->OutputHeight = height;
+    this->allocate();
+}
+
+void PostProcessor::SetRenderScale(float scale)
+{
+    scale = std::clamp(scale, 0.25f, 1.0f);
+    if (scale == this->RenderScale)
+        return;
+    this->RenderScale = scale;
+    this->allocate();
+}
+
+void PostProcessor::BeginRender()
+{
+    this->direct = !this->EffectsActive() && this->AA != AA_FXAA;
+    // count the frame for every path, so chain targets also age out once the chain is cleared or no effect is on
+    this->targets.EndFrame();
+    GLStateCache::BindFramebuffer(GL_FRAMEBUFFER, this->MSFBO);
+    glViewport(0, 0, this->Width, this->Height);
     glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
     glClear(GL_COLOR_BUFFER_BIT);
 }
 void PostProcessor::EndRender() const
 {
-    // now resolve multisampled color-buffer into intermediate FBO to store to texture
-    glBindFramebuffer(GL_READ_FRAMEBUFFER, this->MSFBO);
-    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, this->FBO);
-    glBlitFramebuffer(0, 0, this->Width, this->Height, 0, 0, this->Width, this->Height, GL_COLOR_BUFFER_BIT, GL_NEAREST);
-    glBindFramebuffer(GL_FRAMEBUFFER, 0); // binds both READ and WRITE framebuffer to default framebuffer
+    // now resolve multisampled color-buffer into intermediate FBO to store to texture;
+    // without effects Render()/RenderToCache() resolve it into their target instead, unless it has to be
+    // scaled up on the way, which a multisampled read buffer can't be, or the screen has another format
+    if (!this->direct || (this->Samples > 0 && (this->scaled() || !this->screenRGBA8)))
+        this->resolve(this->FBO);
+    GLStateCache::BindFramebuffer(GL_FRAMEBUFFER, 0); // binds both READ and WRITE framebuffer to default framebuffer
+    // whatever is drawn after the scene (overlays) covers the whole output
+    glViewport(0, 0, this->OutputWidth, this->OutputHeight);
 }
 
-void PostProcessor::Render(const float time)
+void PostProcessor::Render()
 {
-    // set uniforms/options
-    this->PostProcessingShader.Use();
-    this->PostProcessingShader.SetFloat("time", time);
-    this->PostProcessingShader.SetInteger("confuse", this->Confuse);
-    this->PostProcessingShader.SetInteger("chaos", this->Chaos);
-    this->PostProcessingShader.SetInteger("shake", this->Shake);
-    // render textured quad
-    glActiveTexture(GL_TEXTURE0);
-    this->Texture.Bind();
-    glBindVertexArray(this->VAO);
-    glDrawArrays(GL_TRIANGLES, 0, 6);
-    glBindVertexArray(0);
+    if (this->direct)
+    {
+        this->present(0);
+        GLStateCache::BindFramebuffer(GL_FRAMEBUFFER, 0);
+    }
+    else
+        this->render(0);
+}
+
+void PostProcessor::RenderToCache()
+{
+    if (this->direct)
+        this->present(this->cacheFBO);
+    else
+        this->render(this->cacheFBO);
+    GLStateCache::BindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+void PostProcessor::PresentCache() const
+{
+    GLStateCache::BindFramebuffer(GL_READ_FRAMEBUFFER, this->cacheFBO);
+    GLStateCache::BindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
+    glBlitFramebuffer(0, 0, this->OutputWidth, this->OutputHeight, 0, 0, this->OutputWidth, this->OutputHeight,
+                      GL_COLOR_BUFFER_BIT, GL_NEAREST);
+    GLStateCache::BindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+void PostProcessor::AddBlur(float radius)
+{
+    this->chain.push_back({ PASS_BLUR, radius, 0.0f, 0.0f, 0 });
+}
+
+void PostProcessor::AddBloom(float threshold, float intensity, unsigned int levels)
+{
+    this->chain.push_back({ PASS_BLOOM, 0.0f, threshold, intensity, levels });
+}
+
+void PostProcessor::AddEdge()
+{
+    this->chain.push_back({ PASS_EDGE, 0.0f, 0.0f, 0.0f, 0 });
+}
+
+void PostProcessor::AddInvert()
+{
+    this->chain.push_back({ PASS_INVERT, 0.0f, 0.0f, 0.0f, 0 });
+}
+
+void PostProcessor::ClearChain()
+{
+    this->chain.clear();
 }
 
 void PostProcessor::initRenderData()
@@ -105,12 +247,158 @@ void PostProcessor::initRenderData()
     glGenVertexArrays(1, &this->VAO);
     glGenBuffers(1, &VBO);
 
-    glBindBuffer(GL_ARRAY_BUFFER, VBO);
+    GLStateCache::BindBuffer(GL_ARRAY_BUFFER, VBO);
     glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
 
-    glBindVertexArray(this->VAO);
+    GLStateCache::BindVertexArray(this->VAO);
     glEnableVertexAttribArray(0);
     glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)0);
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
-    glBindVertexArray(0);
-}
\ No newline at end of file
+    GLStateCache::BindBuffer(GL_ARRAY_BUFFER, 0);
+    GLStateCache::BindVertexArray(0);
+}
+
+void PostProcessor::allocate()
+{
+    this->Width = std::max(1u, static_cast<unsigned int>(this->OutputWidth * this->RenderScale + 0.5f));
+    this->Height = std::max(1u, static_cast<unsigned int>(this->OutputHeight * this->RenderScale + 0.5f));
+    // the textures keep their IDs and stay attached to their FBOs, only their storage is replaced
+    this->SetSamples(this->Samples);
+    this->Texture.Generate(this->Width, this->Height, NULL);
+    this->cache.Generate(this->OutputWidth, this->OutputHeight, NULL);
+    // targets of the old size are of no use anymore
+    this->targets.EndFrame(0);
+}
+
+unsigned int PostProcessor::variant() const
+{
+    return (this->Chaos ? POST_CHAOS : 0) | (this->Confuse ? POST_CONFUSE : 0) | (this->Shake ? POST_SHAKE : 0)
+         | (this->Quality == EFFECTS_REDUCED ? POST_REDUCED : 0) | (this->AA == AA_FXAA ? POST_FXAA : 0);
+}
+
+void PostProcessor::resolve(unsigned int framebuffer) const
+{
+    GLStateCache::BindFramebuffer(GL_READ_FRAMEBUFFER, this->MSFBO);
+    GLStateCache::BindFramebuffer(GL_DRAW_FRAMEBUFFER, framebuffer);
+    glBlitFramebuffer(0, 0, this->Width, this->Height, 0, 0, this->Width, this->Height, GL_COLOR_BUFFER_BIT, GL_NEAREST);
+}
+
+void PostProcessor::present(unsigned int framebuffer) const
+{
+    if (!this->scaled() && (framebuffer != 0 || this->screenRGBA8))
+    {
+        this->resolve(framebuffer);
+        return;
+    }
+    // a multisampled scene was resolved into the texture's FBO by EndRender(); single sampled blits may scale
+    // and convert formats
+    GLStateCache::BindFramebuffer(GL_READ_FRAMEBUFFER, this->Samples > 0 ? this->FBO : this->MSFBO);
+    GLStateCache::BindFramebuffer(GL_DRAW_FRAMEBUFFER, framebuffer);
+    glBlitFramebuffer(0, 0, this->Width, this->Height, 0, 0, this->OutputWidth, this->OutputHeight,
+                      GL_COLOR_BUFFER_BIT, this->scaled() ? GL_LINEAR : GL_NEAREST);
+}
+
+void PostProcessor::render(unsigned int framebuffer)
+{
+    // chain passes overwrite their targets, only the upsampling of bloom blends
+    GLStateCache::SetBlend(false);
+    // the resolved scene is where the chain starts
+    RenderTarget scene = { this->FBO, this->Texture, this->Width, this->Height, GL_RGBA8, GL_REPEAT, true, 0 };
+    RenderTarget *image = &scene;
+    // radii are given in output pixels, the chain runs at the render scale
+    float pixelScale = static_cast<float>(this->Width) / this->OutputWidth;
+    for (const PostEffect &effect : this->chain)
+    {
+        if (effect.Pass == PASS_BLUR)
+            this->blur(*image, effect.Radius * pixelScale);
+        else if (effect.Pass == PASS_BLOOM)
+            this->bloom(*image, effect);
+        else
+            image = this->filter(effect.Pass == PASS_EDGE ? this->edgeShader : this->invertShader, image, scene);
+    }
+    // shake blurs the image before the quad is moved; chaos and confuse take the place of the blur
+    if (this->Shake && this->Quality == EFFECTS_FULL && !this->Chaos && !this->Confuse)
+        this->blur(*image, this->ShakeBlur * pixelScale);
+    // the permutation of the active effects has them compiled in (time comes from the FrameData block);
+    // drawing the quad at the output size scales the scene up to it
+    GLStateCache::BindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+    glViewport(0, 0, this->OutputWidth, this->OutputHeight);
+    this->variants[this->variant()].Use();
+    // render textured quad
+    image->Texture.Bind();
+    GLStateCache::BindVertexArray(this->VAO);
+    glDrawArrays(GL_TRIANGLES, 0, 6);
+    if (image != &scene)
+        this->targets.Release(image);
+    // back to the premultiplied blending everything else draws with
+    GLStateCache::SetBlend(true);
+    GLStateCache::BlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+}
+
+void PostProcessor::pass(Shader &shader, const RenderTarget &source, const RenderTarget &destination)
+{
+    GLStateCache::BindFramebuffer(GL_FRAMEBUFFER, destination.FBO);
+    glViewport(0, 0, destination.Width, destination.Height);
+    shader.Use();
+    shader.SetVector2f(TEXEL_SIZE, 1.0f / source.Width, 1.0f / source.Height);
+    source.Texture.Bind();
+    GLStateCache::BindVertexArray(this->VAO);
+    glDrawArrays(GL_TRIANGLES, 0, 6);
+}
+
+void PostProcessor::blur(RenderTarget &source, float radius)
+{
+    int texels = static_cast<int>(std::ceil(std::min(radius, static_cast<float>(BLUR_MAX_RADIUS))));
+    if (texels < 1)
+        return;
+    this->blurShader.Use();
+    this->blurShader.SetInteger(RADIUS, texels);
+    this->blurShader.SetFloat(SIGMA, radius * 0.5f + 0.5f);
+    // horizontally into a temporary target, vertically back into the source
+    RenderTarget *temporary = this->targets.Acquire(source.Width, source.Height, source.Format);
+    this->blurShader.SetVector2f(DIRECTION, 1.0f, 0.0f);
+    this->pass(this->blurShader, source, *temporary);
+    this->blurShader.SetVector2f(DIRECTION, 0.0f, 1.0f);
+    this->pass(this->blurShader, *temporary, source);
+    this->targets.Release(temporary);
+}
+
+void PostProcessor::bloom(RenderTarget &source, const PostEffect &effect)
+{
+    // bright pass into the first half-sized mip, then halve down the chain; half float so the glow doesn't band
+    RenderTarget *mips[BLOOM_MAX_LEVELS];
+    unsigned int levels = 0;
+    unsigned int width = source.Width / 2, height = source.Height / 2;
+    const RenderTarget *from = &source;
+    while (levels < std::min(effect.Levels, BLOOM_MAX_LEVELS) && width > 0 && height > 0)
+    {
+        mips[levels] = this->targets.Acquire(width, height, GL_RGBA16F);
+        if (levels == 0)
+            this->brightShader.Use().SetFloat(THRESHOLD, effect.Threshold);
+        this->pass(levels == 0 ? this->brightShader : this->downsampleShader, *from, *mips[levels]);
+        from = mips[levels++];
+        width /= 2;
+        height /= 2;
+    }
+    if (levels == 0)
+        return;
+    // walk back up, adding every mip onto the next larger one and the last onto the source
+    GLStateCache::SetBlend(true);
+    GLStateCache::BlendFunc(GL_ONE, GL_ONE);
+    for (unsigned int i = levels; i-- > 0; )
+    {
+        this->upsampleShader.Use().SetFloat(INTENSITY, i > 0 ? 1.0f : effect.Intensity);
+        this->pass(this->upsampleShader, *mips[i], i > 0 ? *mips[i - 1] : source);
+        this->targets.Release(mips[i]);
+    }
+    GLStateCache::SetBlend(false);
+}
+
+RenderTarget *PostProcessor::filter(Shader &shader, RenderTarget *source, const RenderTarget &scene)
+{
+    // the result may feed the composite, whose chaos shift relies on wrapping around like the scene does
+    RenderTarget *destination = this->targets.Acquire(source->Width, source->Height, GL_RGBA8, GL_REPEAT);
+    this->pass(shader, *source, *destination);
+    if (source != &scene)
+        this->targets.Release(source);
+    return destination;
+}
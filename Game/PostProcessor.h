@@ -6,44 +6,170 @@
 #define POSTPROCESSOR_H
 
 
+#include <string>
+#include <vector>
+
 #include <glad/glad.h>
 #include <glm/glm.hpp>
 
-#include "shader.h"
+#include "Shader.h"
 #include "Texture2D.h"
+#include "RenderTargetPool.h"
+
 
+// How much the full screen effects may cost
+enum EffectQuality
+{
+    EFFECTS_REDUCED, // shake without the blur, chaos with a 5 instead of 9 tap edge kernel
+    EFFECTS_FULL
+};
+
+// How the scene is anti-aliased
+enum AntiAliasing
+{
+    AA_OFF,
+    AA_MSAA_2X,
+    AA_MSAA_4X,
+    AA_MSAA_8X,
+    AA_FXAA,    // single sampled scene, edges smoothed in the post-processing pass
+    AA_MODES
+};
+
+// Passes of the effect chain
+enum PostPass
+{
+    PASS_BLUR,   // separable gaussian, cost linear in the radius
+    PASS_BLOOM,  // bright pass, downsample and upsample through a mip chain, added back onto the image
+    PASS_EDGE,   // 3x3 edge detection
+    PASS_INVERT  // inverted colors
+};
+
+// A pass of the effect chain and its parameters
+struct PostEffect
+{
+    PostPass     Pass;
+    float        Radius;     // blur radius in output pixels
+    float        Threshold;  // bloom: brightness that starts to glow
+    float        Intensity;  // bloom: strength of the glow added back
+    unsigned int Levels;     // bloom: number of half-sized mips
+};
 
 // PostProcessor hosts all PostProcessing effects for the Breakout
 // Game. It renders the game on a textured quad after which one can
 // enable specific effects by enabling either the Confuse, Chaos or
-// Shake boolean.
+// Shake boolean. Each combination of effects (and quality) renders
+// with its own shader permutation, so no branches or uniforms are
+// left for effects that are off.
 // It is required to call BeginRender() before rendering the game
 // and EndRender() after rendering the game for the class to work.
+// While no effect is on, the multisampled scene is resolved straight
+// into the target of Render()/RenderToCache() and the texture pass is
+// skipped.
+// Before the effects above, the scene runs through an effect chain of
+// full-screen passes (AddBlur, AddBloom, AddEdge, AddInvert); their
+// intermediate textures come from a RenderTargetPool.
+// The scene is rendered at RenderScale times the output (framebuffer)
+// size and scaled up to it by the post-processing pass; Resize() and
+// SetRenderScale() reallocate the buffers.
+// Anti-aliasing is either multisampling of the scene buffer or FXAA
+// in the post-processing pass, see SetAntiAliasing().
 class PostProcessor
 {
 public:
     // state
-    Shader PostProcessingShader;
     Texture2D Texture;
+    // size the scene is rendered at, RenderScale times the output size
     unsigned int Width, Height;
+    // size of the framebuffer Render()/PresentCache() draw to
+    unsigned int OutputWidth, OutputHeight;
+    // fraction of the output size the scene is rendered at, see SetRenderScale
+    float RenderScale;
+    // samples of the multisampled scene buffer (0 = no multisampling), see SetAntiAliasing and SetSamples
+    unsigned int Samples;
+    AntiAliasing AA;
     // options
     bool Confuse, Chaos, Shake;
-    // constructor
-    PostProcessor(Shader shader, unsigned int width, unsigned int height);
-    // prepares the postprocessor's framebuffer operations before rendering the game
-    void BeginRender() const;
+    EffectQuality Quality;
+    // radius in output pixels of the blur while Shake is on (EFFECTS_FULL only)
+    float ShakeBlur;
+    // constructor; shader and chainShader name shaders loaded by ResourceManager::LoadShader (post_processing and
+    // post_chain), all their permutations are compiled up front
+    PostProcessor(std::string shader, std::string chainShader, unsigned int width, unsigned int height,
+                  unsigned int samples = 4);
+    // reallocates the scene buffer with the given number of samples (clamped to what the driver supports);
+    // the quality governor lowers the samples of an MSAA mode with it
+    void SetSamples(unsigned int samples);
+    // switches the anti-aliasing mode, reallocating the scene buffer with all samples of the mode
+    void SetAntiAliasing(AntiAliasing mode);
+    // MSAA samples of a mode (0 for off and FXAA)
+    static unsigned int AntiAliasingSamples(AntiAliasing mode);
+    // short name of a mode, as shown in the stats and accepted on the command line
+    static const char *AntiAliasingName(AntiAliasing mode);
+    // the framebuffer changed size; reallocates the scene buffers and the screen cache
+    void Resize(unsigned int width, unsigned int height);
+    // renders the scene at scale (clamped to [0.25, 1]) times the output size, reallocates the scene buffers
+    void SetRenderScale(float scale);
+    // appends a pass to the effect chain, which runs in order on every frame
+    void AddBlur(float radius);
+    void AddBloom(float threshold = 0.8f, float intensity = 1.0f, unsigned int levels = 5);
+    void AddEdge();
+    void AddInvert();
+    // removes all passes of the effect chain
+    void ClearChain();
+    // whether any effect is on and the frame needs the post-processing pass
+    bool EffectsActive() const { return this->Confuse || this->Chaos || this->Shake || !this->chain.empty(); }
+    // prepares the postprocessor's framebuffer operations before rendering the game; decides for the whole frame
+    // whether it goes through the post-processing pass, effects toggled before the next call apply from then on
+    void BeginRender();
     // should be called after rendering the game, so it stores all the rendered data into a texture object
     void EndRender() const;
-    // renders the PostProcessor texture quad (as a screen-encompassing large sprite)
-    void Render(float time);
+    // renders the PostProcessor texture quad (as a screen-encompassing large sprite), or just resolves the scene
+    // into the default framebuffer when no effect was on at BeginRender()
+    void Render();
+    // renders the PostProcessor texture quad into the screen cache instead of the default framebuffer
+    void RenderToCache();
+    // copies the screen cache to the default framebuffer
+    void PresentCache() const;
 
 private:
     // render state
     unsigned int MSFBO, FBO; // MSFBO = Multisampled FBO. FBO is regular, used for blitting MS color-buffer to texture
     unsigned int RBO; // RBO is used for multisampled color buffer
+    unsigned int cacheFBO; // holds a finished frame for static screens
+    Texture2D cache;
     unsigned int VAO;
+    // no effect (nor FXAA) was on at BeginRender(): skip the texture and resolve straight into the final target
+    bool direct;
+    // the default framebuffer is RGBA8 like the scene buffer; GL 3.3 only resolves a multisampled buffer into
+    // one of the same format, other screens get the resolved texture blitted instead
+    bool screenRGBA8;
+    // shader permutation per effect set, indexed by the POST_* bits
+    static const unsigned int POST_VARIANTS = 32;
+    Shader variants[POST_VARIANTS];
+    // effect chain and the permutations of its passes
+    std::vector<PostEffect> chain;
+    Shader blurShader, brightShader, downsampleShader, upsampleShader, edgeShader, invertShader;
+    RenderTargetPool targets;
     // initialize quad for rendering postprocessing texture
     void initRenderData();
+    // sizes the scene buffers for the output size and render scale, and the cache for the output size
+    void allocate();
+    // whether the scene is rendered at a lower resolution than the output
+    bool scaled() const { return this->Width != this->OutputWidth || this->Height != this->OutputHeight; }
+    // POST_* bits of the shader permutation the current effects and quality render with
+    unsigned int variant() const;
+    // resolves the multisampled scene into the given framebuffer, at the scene size
+    void resolve(unsigned int framebuffer) const;
+    // copies the scene straight into the given framebuffer without effects, scaled up to the output size
+    void present(unsigned int framebuffer) const;
+    // runs the effect chain and the effects onto the given framebuffer
+    void render(unsigned int framebuffer);
+    // draws source through shader into destination
+    void pass(Shader &shader, const RenderTarget &source, const RenderTarget &destination);
+    // chain passes; source is blurred/bloomed in place, the others return a new target
+    void blur(RenderTarget &source, float radius);
+    void bloom(RenderTarget &source, const PostEffect &effect);
+    RenderTarget *filter(Shader &shader, RenderTarget *source, const RenderTarget &scene);
 };
 
 
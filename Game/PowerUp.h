@@ -5,6 +5,7 @@
 #ifndef POWERUP_H
 #define POWERUP_H
 #include "GameObject.h"
+#include "RibbonTrail.h"
 const glm::vec2 SIZE(60.0f, 20.0f);
 const glm::vec2 VELOCITY(0.0f, 150.0f);
 
@@ -25,11 +26,13 @@ public:
     PowerUpType Type;
     float       Duration;
     bool        Activated;
+    // where the powerup has recently been
+    RibbonTrail Trail;
     // constructor
     PowerUp(PowerUpType type, glm::vec3 color, float duration,
             glm::vec2 position, Texture2D texture)
         : GameObject(position, SIZE, texture, color, VELOCITY),
-          Type(type), Duration(duration), Activated()
+          Type(type), Duration(duration), Activated(), Trail(16)
     { }
 };
 #endif //POWERUP_H
@@ -0,0 +1,149 @@
+#include "QualityGovernor.h"
+
+#include <algorithm>
+#include <iostream>
+#include <sstream>
+
+// frames the slower time has to stay over budget before quality is lowered
+static const unsigned int DEGRADE_FRAMES = 30;
+// frames it has to stay under HEADROOM * budget before quality is raised again
+static const unsigned int RESTORE_FRAMES = 180;
+static const float HEADROOM = 0.7f;
+// frames to let the times settle after a change before judging them again
+static const unsigned int COOLDOWN_FRAMES = 60;
+// weight of the newest frame in the smoothed times
+static const float SMOOTHING = 0.1f;
+
+
+QualityGovernor::QualityGovernor(const QualityKnobs &best, const QualityKnobs &worst, float budget)
+    : CpuTime(0.0f), GpuTime(0.0f), level(0), budget(budget), overFrames(0), headroomFrames(0),
+      cooldown(COOLDOWN_FRAMES), oldestQuery(0), pendingQueries(0), timing(false)
+{
+    this->SetRange(best, worst);
+    glGenQueries(QUERY_COUNT, this->queries);
+}
+
+QualityGovernor::~QualityGovernor()
+{
+    glDeleteQueries(QUERY_COUNT, this->queries);
+}
+
+void QualityGovernor::SetRange(const QualityKnobs &best, const QualityKnobs &worst)
+{
+    // build the ladder from best to worst, one knob per step; knobs already at their worst get no steps
+    QualityKnobs knobs = best;
+    this->levels.clear();
+    this->levels.push_back(knobs);
+    while (knobs.ParticleScale > worst.ParticleScale)
+    {
+        knobs.ParticleScale = std::max(knobs.ParticleScale * 0.5f, worst.ParticleScale);
+        this->levels.push_back(knobs);
+    }
+    while (knobs.Samples > worst.Samples)
+    {
+        // 1 sample is no cheaper than none
+        knobs.Samples = knobs.Samples / 2 >= std::max(worst.Samples, 2u) ? knobs.Samples / 2 : worst.Samples;
+        this->levels.push_back(knobs);
+    }
+    while (knobs.RenderScale > worst.RenderScale)
+    {
+        // an eighth of the resolution per step; fill rate drops with its square
+        knobs.RenderScale = std::max(knobs.RenderScale - 0.125f, worst.RenderScale);
+        this->levels.push_back(knobs);
+    }
+    if (knobs.Effects > worst.Effects)
+    {
+        knobs.Effects = worst.Effects;
+        this->levels.push_back(knobs);
+    }
+    if (knobs.TextScale > worst.TextScale)
+    {
+        knobs.TextScale = worst.TextScale;
+        this->levels.push_back(knobs);
+    }
+    this->level = std::min(this->level, static_cast<unsigned int>(this->levels.size()) - 1);
+    this->overFrames = this->headroomFrames = 0;
+    this->cooldown = COOLDOWN_FRAMES;
+}
+
+void QualityGovernor::BeginFrame()
+{
+    this->frameStart = std::chrono::steady_clock::now();
+    // skip the GPU timing of this frame if all queries are still in flight
+    this->timing = this->pendingQueries < QUERY_COUNT;
+    if (this->timing)
+        glBeginQuery(GL_TIME_ELAPSED, this->queries[(this->oldestQuery + this->pendingQueries) % QUERY_COUNT]);
+}
+
+bool QualityGovernor::EndFrame()
+{
+    if (this->timing)
+    {
+        glEndQuery(GL_TIME_ELAPSED);
+        ++this->pendingQueries;
+    }
+    float cpu = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - this->frameStart).count();
+    this->CpuTime += (cpu - this->CpuTime) * SMOOTHING;
+    this->collectQueries();
+    if (this->cooldown > 0)
+    {
+        --this->cooldown;
+        return false;
+    }
+    float frameTime = std::max(this->CpuTime, this->GpuTime);
+    this->overFrames = frameTime > this->budget ? this->overFrames + 1 : 0;
+    this->headroomFrames = frameTime < this->budget * HEADROOM ? this->headroomFrames + 1 : 0;
+    if (this->overFrames >= DEGRADE_FRAMES && this->level + 1 < this->levels.size())
+    {
+        this->changeLevel(this->level + 1, "over budget");
+        return true;
+    }
+    if (this->headroomFrames >= RESTORE_FRAMES && this->level > 0)
+    {
+        this->changeLevel(this->level - 1, "headroom");
+        return true;
+    }
+    return false;
+}
+
+std::string QualityGovernor::Describe(const QualityKnobs &knobs)
+{
+    std::stringstream ss;
+    ss << "particles " << static_cast<int>(knobs.ParticleScale * 100.0f + 0.5f) << "%, MSAA ";
+    if (knobs.Samples > 0)
+        ss << knobs.Samples << "x";
+    else
+        ss << "off";
+    ss << ", scale " << static_cast<int>(knobs.RenderScale * 100.0f + 0.5f) << "%"
+       << ", effects " << (knobs.Effects == EFFECTS_FULL ? "full" : "reduced")
+       << ", text " << static_cast<int>(knobs.TextScale * 100.0f + 0.5f) << "%";
+    return ss.str();
+}
+
+void QualityGovernor::collectQueries()
+{
+    // results arrive in order, stop at the first one that isn't there yet
+    while (this->pendingQueries > 0)
+    {
+        unsigned int query = this->queries[this->oldestQuery];
+        int available = 0;
+        glGetQueryObjectiv(query, GL_QUERY_RESULT_AVAILABLE, &available);
+        if (!available)
+            break;
+        GLuint64 elapsed;
+        glGetQueryObjectui64v(query, GL_QUERY_RESULT, &elapsed);
+        this->GpuTime += (elapsed / 1000000.0f - this->GpuTime) * SMOOTHING;
+        this->oldestQuery = (this->oldestQuery + 1) % QUERY_COUNT;
+        --this->pendingQueries;
+    }
+}
+
+void QualityGovernor::changeLevel(unsigned int level, const char *reason)
+{
+    std::cout << "QUALITY::GOVERNOR: " << reason << " (cpu " << this->CpuTime << " ms, gpu " << this->GpuTime
+              << " ms, budget " << this->budget << " ms), level " << this->level << " -> " << level << ": "
+              << Describe(this->levels[level]) << std::endl;
+    this->level = level;
+    this->overFrames = this->headroomFrames = 0;
+    this->cooldown = COOLDOWN_FRAMES;
+}
@@ -0,0 +1,77 @@
+#ifndef PROJEKT1_QUALITYGOVERNOR_H
+#define PROJEKT1_QUALITYGOVERNOR_H
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include "PostProcessor.h"
+
+
+// Settings the QualityGovernor trades for frame time
+struct QualityKnobs
+{
+    float         ParticleScale; // fraction of the particles emitters spawn
+    unsigned int  Samples;       // MSAA samples of the scene buffer, 0 = off
+    float         RenderScale;   // resolution the scene renders at relative to the framebuffer
+    EffectQuality Effects;       // cost of the post-processing effects
+    float         TextScale;     // glyph resolution relative to the loaded font size
+};
+
+
+// QualityGovernor watches how long frames take on the CPU (wall time
+// between BeginFrame and EndFrame) and on the GPU (GL_TIME_ELAPSED
+// queries, read back a few frames late so they never stall) and steps
+// through a ladder of quality levels between the configured best and
+// worst knobs, one knob at a time, cheapest loss first: particles,
+// MSAA, render scale, effects, text resolution. A level is dropped after the slower
+// of the two times exceeded the budget for a while and only restored
+// after a much longer stretch well below it, so it doesn't oscillate.
+// Every decision is logged.
+class QualityGovernor
+{
+public:
+    // smoothed frame times in milliseconds
+    float CpuTime, GpuTime;
+    // constructor/destructor; budget is the frame time to stay under in milliseconds
+    QualityGovernor(const QualityKnobs &best, const QualityKnobs &worst, float budget);
+    ~QualityGovernor();
+    // rebuilds the ladder between new best and worst knobs (e.g. another anti-aliasing mode changed the best
+    // MSAA samples), staying on the current level as far as the new ladder reaches; Knobs() need to be applied
+    void SetRange(const QualityKnobs &best, const QualityKnobs &worst);
+    // starts timing a frame
+    void BeginFrame();
+    // stops timing the frame; returns true if the level changed and Knobs() need to be applied
+    bool EndFrame();
+    // settings of the current level
+    const QualityKnobs &Knobs() const { return this->levels[this->level]; }
+    // current level, 0 is the best / number of levels
+    unsigned int Level() const { return this->level; }
+    unsigned int Levels() const { return static_cast<unsigned int>(this->levels.size()); }
+    // human readable knob settings, for the log and the stats overlay
+    static std::string Describe(const QualityKnobs &knobs);
+
+private:
+    // frames in flight the GPU timer queries are spread over
+    static const unsigned int QUERY_COUNT = 4;
+    std::vector<QualityKnobs> levels;
+    unsigned int level;
+    float budget;
+    // hysteresis state: consecutive frames over budget / with headroom, frames left before the next decision
+    unsigned int overFrames, headroomFrames, cooldown;
+    // GPU timing: ring of queries, the oldest pending one and how many are pending
+    unsigned int queries[QUERY_COUNT];
+    unsigned int oldestQuery, pendingQueries;
+    bool timing;
+    std::chrono::steady_clock::time_point frameStart;
+    // disable copying, the queries are owned
+    QualityGovernor(const QualityGovernor &) = delete;
+    QualityGovernor &operator=(const QualityGovernor &) = delete;
+    // folds in the results of all finished GPU queries
+    void collectQueries();
+    // moves to the given level and logs why
+    void changeLevel(unsigned int level, const char *reason);
+};
+
+
+#endif //PROJEKT1_QUALITYGOVERNOR_H
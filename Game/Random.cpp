@@ -0,0 +1,180 @@
+#include "Random.h"
+
+#include <algorithm>
+
+#if !defined(PROJEKT1_NO_SIMD) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define RANDOM_FILL_SSE2
+#include <emmintrin.h>
+#endif
+
+
+// instantiate static variables
+uint64_t Random::seed = 0;
+Rng Random::streams[RANDOM_STREAM_COUNT];
+
+// 2^-24, turns the top 24 bits of a draw into a float in [0, 1)
+static const float FLOAT_UNIT = 1.0f / 16777216.0f;
+
+
+static inline uint32_t rotl(uint32_t x, int k)
+{
+    return (x << k) | (x >> (32 - k));
+}
+
+// splitmix64, spreads a seed over the generator state
+static uint64_t splitMix(uint64_t &x)
+{
+    uint64_t z = (x += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+Rng::Rng(uint64_t seed)
+{
+    this->Seed(seed);
+}
+
+void Rng::Seed(uint64_t seed)
+{
+    uint64_t x = seed;
+    for (unsigned int i = 0; i < 4; i += 2)
+    {
+        uint64_t z = splitMix(x);
+        this->state[i] = static_cast<uint32_t>(z);
+        this->state[i + 1] = static_cast<uint32_t>(z >> 32);
+    }
+    for (unsigned int lane = 0; lane < 4; ++lane)
+        for (unsigned int i = 0; i < 4; i += 2)
+        {
+            uint64_t z = splitMix(x);
+            this->lanes[i][lane] = static_cast<uint32_t>(z);
+            this->lanes[i + 1][lane] = static_cast<uint32_t>(z >> 32);
+        }
+}
+
+uint32_t Rng::Next()
+{
+    uint32_t *s = this->state;
+    uint32_t result = rotl(s[1] * 5, 7) * 9;
+    uint32_t t = s[1] << 9;
+    s[2] ^= s[0];
+    s[3] ^= s[1];
+    s[1] ^= s[2];
+    s[0] ^= s[3];
+    s[2] ^= t;
+    s[3] = rotl(s[3], 11);
+    return result;
+}
+
+uint32_t Rng::Below(uint32_t bound)
+{
+    // Lemire's multiply-shift, rejecting the few low products that would favour some results
+    uint64_t m = static_cast<uint64_t>(this->Next()) * bound;
+    uint32_t low = static_cast<uint32_t>(m);
+    if (low < bound)
+    {
+        uint32_t threshold = (0u - bound) % bound;
+        while (low < threshold)
+        {
+            m = static_cast<uint64_t>(this->Next()) * bound;
+            low = static_cast<uint32_t>(m);
+        }
+    }
+    return static_cast<uint32_t>(m >> 32);
+}
+
+float Rng::Float()
+{
+    return (this->Next() >> 8) * FLOAT_UNIT;
+}
+
+float Rng::Range(float min, float max)
+{
+    return min + this->Float() * (max - min);
+}
+
+void Rng::Fill(float *out, unsigned int count, float min, float max)
+{
+    // the four lane generators are stepped together; value i comes from lane i % 4
+#if defined(RANDOM_FILL_SSE2)
+    __m128i s0 = _mm_load_si128(reinterpret_cast<const __m128i *>(this->lanes[0]));
+    __m128i s1 = _mm_load_si128(reinterpret_cast<const __m128i *>(this->lanes[1]));
+    __m128i s2 = _mm_load_si128(reinterpret_cast<const __m128i *>(this->lanes[2]));
+    __m128i s3 = _mm_load_si128(reinterpret_cast<const __m128i *>(this->lanes[3]));
+    const __m128 unit = _mm_set1_ps(FLOAT_UNIT), base = _mm_set1_ps(min), scale = _mm_set1_ps(max - min);
+    for (unsigned int i = 0; i < count; i += 4)
+    {
+        // SSE2 has no 32-bit multiply: x * 5 = x + (x << 2), x * 9 = x + (x << 3)
+        __m128i r = _mm_add_epi32(s1, _mm_slli_epi32(s1, 2));
+        r = _mm_or_si128(_mm_slli_epi32(r, 7), _mm_srli_epi32(r, 25));
+        r = _mm_add_epi32(r, _mm_slli_epi32(r, 3));
+        __m128i t = _mm_slli_epi32(s1, 9);
+        s2 = _mm_xor_si128(s2, s0);
+        s3 = _mm_xor_si128(s3, s1);
+        s1 = _mm_xor_si128(s1, s2);
+        s0 = _mm_xor_si128(s0, s3);
+        s2 = _mm_xor_si128(s2, t);
+        s3 = _mm_or_si128(_mm_slli_epi32(s3, 11), _mm_srli_epi32(s3, 21));
+        __m128 f = _mm_mul_ps(_mm_cvtepi32_ps(_mm_srli_epi32(r, 8)), unit);
+        f = _mm_add_ps(base, _mm_mul_ps(f, scale));
+        if (i + 4 <= count)
+            _mm_storeu_ps(out + i, f);
+        else
+        {
+            alignas(16) float tail[4];
+            _mm_store_ps(tail, f);
+            std::copy(tail, tail + (count - i), out + i);
+        }
+    }
+    _mm_store_si128(reinterpret_cast<__m128i *>(this->lanes[0]), s0);
+    _mm_store_si128(reinterpret_cast<__m128i *>(this->lanes[1]), s1);
+    _mm_store_si128(reinterpret_cast<__m128i *>(this->lanes[2]), s2);
+    _mm_store_si128(reinterpret_cast<__m128i *>(this->lanes[3]), s3);
+#else
+    uint32_t (*s)[4] = this->lanes;
+    for (unsigned int i = 0; i < count; i += 4)
+        for (unsigned int lane = 0; lane < 4; ++lane)
+        {
+            uint32_t result = rotl(s[1][lane] * 5, 7) * 9;
+            uint32_t t = s[1][lane] << 9;
+            s[2][lane] ^= s[0][lane];
+            s[3][lane] ^= s[1][lane];
+            s[1][lane] ^= s[2][lane];
+            s[0][lane] ^= s[3][lane];
+            s[2][lane] ^= t;
+            s[3][lane] = rotl(s[3][lane], 11);
+            if (i + lane < count)
+                out[i + lane] = min + ((result >> 8) * FLOAT_UNIT) * (max - min);
+        }
+#endif
+}
+
+void Random::Seed(uint64_t seed)
+{
+    Random::seed = seed;
+    // every stream gets its own, well separated seed
+    for (unsigned int i = 0; i < RANDOM_STREAM_COUNT; ++i)
+        streams[i].Seed(seed ^ (0xD1B54A32D192ED03ull * (i + 1)));
+}
+
+DiscreteDistribution::DiscreteDistribution(const std::vector<float> &weights, float total)
+{
+    if (total <= 0.0f)
+        for (float weight : weights)
+            total += weight;
+    float running = 0.0f;
+    for (float weight : weights)
+    {
+        running += weight;
+        this->cumulative.push_back(running / total);
+    }
+}
+
+unsigned int DiscreteDistribution::Pick(Rng &rng) const
+{
+    // the first outcome whose interval ends past the draw
+    float draw = rng.Float();
+    return static_cast<unsigned int>(
+        std::upper_bound(this->cumulative.begin(), this->cumulative.end(), draw) - this->cumulative.begin());
+}
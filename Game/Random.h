@@ -0,0 +1,90 @@
+#ifndef PROJEKT1_RANDOM_H
+#define PROJEKT1_RANDOM_H
+
+#include <cstdint>
+#include <vector>
+
+
+// Rng is a xoshiro128** generator: small, fast and giving the same numbers
+// on every platform for the same seed, unlike rand(). Besides the scalar
+// draws it keeps four more generators for Fill(), which advances them side
+// by side (with SSE2 where available) to produce runs of floats at once.
+// An Rng is not thread-safe, give every thread/subsystem its own.
+class Rng
+{
+public:
+    // constructor, same as Seed(seed)
+    explicit Rng(uint64_t seed = 0);
+    // restarts the sequence (of scalar draws and of Fill) for the given seed
+    void Seed(uint64_t seed);
+    // uniformly distributed 32 bits
+    uint32_t Next();
+    // uniform integer in [0, bound), without modulo bias; bound must not be 0
+    uint32_t Below(uint32_t bound);
+    // uniform float in [0, 1)
+    float Float();
+    // uniform float in [min, max)
+    float Range(float min, float max);
+    // true with a chance of 1 in chance
+    bool OneIn(uint32_t chance) { return this->Below(chance) == 0; }
+    // writes count uniform floats in [min, max) to out; its own sequence, independent of the scalar draws
+    void Fill(float *out, unsigned int count, float min = 0.0f, float max = 1.0f);
+
+private:
+    uint32_t state[4];
+    // state of the four Fill generators, component-major so the SIMD path loads one component of all lanes at once
+    alignas(16) uint32_t lanes[4][4];
+};
+
+
+// Independent random streams of the game's subsystems, see Random::Stream
+enum RandomStream
+{
+    RANDOM_GAMEPLAY,  // powerup rolls and anything else that changes how a game plays out
+    RANDOM_PARTICLES, // particle spawns, purely visual
+    RANDOM_STREAM_COUNT
+};
+
+// A static singleton Random class holding one Rng per subsystem, all
+// derived from a single seed. Keeping the streams apart means cosmetic
+// draws (more or fewer particles) never change the gameplay sequence, so a
+// session replays exactly given the same seed and input.
+class Random
+{
+public:
+    // reseeds every stream from seed
+    static void Seed(uint64_t seed);
+    // seed the streams were last derived from
+    static uint64_t GetSeed() { return seed; }
+    // generator of the given subsystem
+    static Rng &Stream(RandomStream stream) { return streams[stream]; }
+
+private:
+    static uint64_t seed;
+    static Rng streams[RANDOM_STREAM_COUNT];
+    // private constructor, that is we do not want any actual random objects. Its members and functions should be publicly available (static).
+    Random() { }
+};
+
+
+// DiscreteDistribution picks one of several outcomes with given weights
+// using a single draw: the weights are turned into a cumulative
+// distribution once and every Pick() binary-searches it. Outcome i has
+// probability weights[i] / total; with a total below 1 the remainder is
+// the chance of picking nothing.
+class DiscreteDistribution
+{
+public:
+    // constructor; total is what the weights are relative to, by default their sum
+    explicit DiscreteDistribution(const std::vector<float> &weights, float total = 0.0f);
+    // index of the picked outcome, or Count() if none was picked
+    unsigned int Pick(Rng &rng) const;
+    // number of outcomes
+    unsigned int Count() const { return static_cast<unsigned int>(this->cumulative.size()); }
+
+private:
+    std::vector<float> cumulative; // upper bound of each outcome's interval in [0, 1)
+};
+
+
+#endif //PROJEKT1_RANDOM_H
@@ -0,0 +1,117 @@
+#include "RenderQueue.h"
+#include "GLStateCache.h"
+
+#include <utility>
+
+
+// key layout, most significant first: layer (8) | blend (4) | shader (20) | texture (32)
+static const int LAYER_SHIFT = 56;
+static const int BLEND_SHIFT = 52;
+static const int SHADER_SHIFT = 32;
+
+RenderQueue::RenderQueue()
+    : Commands(0), StateChanges(0), StateChangesElided(0)
+{
+}
+
+uint64_t RenderQueue::MakeKey(unsigned int layer, BlendMode blend, unsigned int shader, unsigned int texture)
+{
+    return (static_cast<uint64_t>(layer & 0xFF) << LAYER_SHIFT)
+         | (static_cast<uint64_t>(blend & 0xF) << BLEND_SHIFT)
+         | (static_cast<uint64_t>(shader & 0xFFFFF) << SHADER_SHIFT)
+         | static_cast<uint64_t>(texture);
+}
+
+void RenderQueue::Submit(unsigned int layer, BlendMode blend, unsigned int shader, unsigned int texture,
+                         std::function<void()> draw)
+{
+    this->commands.push_back({ MakeKey(layer, blend, shader, texture), std::move(draw) });
+}
+
+void RenderQueue::Flush()
+{
+    this->entries.resize(this->commands.size());
+    for (unsigned int i = 0; i < this->commands.size(); ++i)
+        this->entries[i] = { this->commands[i].Key, i };
+    this->sort();
+    // submit in key order, only touching state that differs from the previous command
+    unsigned int changes = 0;
+    unsigned int elided = GLStateCache::Frame.Elided;
+    bool first = true;
+    BlendMode currentBlend = BLEND_PREMULTIPLIED;
+    unsigned int currentShader = 0, currentTexture = 0;
+    for (const SortEntry &entry : this->entries)
+    {
+        BlendMode blend = static_cast<BlendMode>((entry.Key >> BLEND_SHIFT) & 0xF);
+        unsigned int shader = static_cast<unsigned int>((entry.Key >> SHADER_SHIFT) & 0xFFFFF);
+        unsigned int texture = static_cast<unsigned int>(entry.Key & 0xFFFFFFFF);
+        if (first || blend != currentBlend)
+        {
+            applyBlend(blend);
+            currentBlend = blend;
+            ++changes;
+        }
+        if (shader != 0 && (first || shader != currentShader))
+        {
+            GLStateCache::UseProgram(shader);
+            currentShader = shader;
+            ++changes;
+        }
+        if (texture != 0 && (first || texture != currentTexture))
+        {
+            GLStateCache::BindTexture(texture);
+            currentTexture = texture;
+            ++changes;
+        }
+        first = false;
+        this->commands[entry.Index].Draw();
+    }
+    this->StateChanges += changes;
+    this->StateChangesElided += GLStateCache::Frame.Elided - elided;
+    this->Commands += static_cast<unsigned int>(this->commands.size());
+    if (currentBlend != BLEND_PREMULTIPLIED)
+        applyBlend(BLEND_PREMULTIPLIED);
+    this->commands.clear();
+}
+
+void RenderQueue::ResetStats()
+{
+    this->Commands = 0;
+    this->StateChanges = 0;
+    this->StateChangesElided = 0;
+}
+
+void RenderQueue::sort()
+{
+    this->scratch.resize(this->entries.size());
+    for (int shift = 0; shift < 64; shift += 8)
+    {
+        unsigned int count[256] = { 0 };
+        for (const SortEntry &entry : this->entries)
+            ++count[(entry.Key >> shift) & 0xFF];
+        // all keys share this digit, nothing to reorder
+        if (count[(this->entries.empty() ? 0 : this->entries[0].Key >> shift) & 0xFF] == this->entries.size())
+            continue;
+        unsigned int offset = 0;
+        for (unsigned int &c : count)
+        {
+            unsigned int n = c;
+            c = offset;
+            offset += n;
+        }
+        for (const SortEntry &entry : this->entries)
+            this->scratch[count[(entry.Key >> shift) & 0xFF]++] = entry;
+        this->entries.swap(this->scratch);
+    }
+}
+
+void RenderQueue::applyBlend(BlendMode blend)
+{
+    if (blend == BLEND_OPAQUE)
+    {
+        GLStateCache::SetBlend(false);
+        return;
+    }
+    GLStateCache::SetBlend(true);
+    GLStateCache::BlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+}
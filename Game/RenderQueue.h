@@ -0,0 +1,75 @@
+#ifndef PROJEKT1_RENDERQUEUE_H
+#define PROJEKT1_RENDERQUEUE_H
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+#include <glad/glad.h>
+
+
+// Blend state a draw command needs. Colors are premultiplied by alpha,
+// so one blend function covers both alpha blended (alpha = coverage)
+// and additive (alpha = 0) drawing.
+enum BlendMode
+{
+    BLEND_OPAQUE,       // blending disabled
+    BLEND_PREMULTIPLIED // GL_ONE, GL_ONE_MINUS_SRC_ALPHA (default)
+};
+
+// Draw order of the scene; commands on a lower layer are always drawn first
+enum RenderLayer
+{
+    LAYER_BACKGROUND,
+    LAYER_LEVEL,
+    LAYER_TRAILS,  // GPU drawn trails (ribbons, transform feedback particles)
+    LAYER_SPRITES, // player, powerups, particles and ball, batched in that order
+    LAYER_OVERLAY
+};
+
+// A single deferred draw: its sort key encodes the state it needs, Draw issues the actual draw call(s)
+struct RenderCommand
+{
+    uint64_t Key;
+    std::function<void()> Draw;
+};
+
+
+// RenderQueue gathers draw commands for a pass, radix-sorts them by a
+// 64-bit key of (layer, blend mode, shader, texture) and submits them
+// so that blend state, program and texture only change when the next
+// command actually needs a different one. Within a layer, commands with
+// equal state keep their submission order.
+class RenderQueue
+{
+public:
+    // statistics since the last ResetStats(); StateChangesElided counts the state calls GLStateCache skipped as
+    // redundant during Flush(), mostly commands binding what the queue already set for them
+    unsigned int Commands, StateChanges, StateChangesElided;
+    // constructor
+    RenderQueue();
+    // builds the sort key of a command
+    static uint64_t MakeKey(unsigned int layer, BlendMode blend, unsigned int shader, unsigned int texture);
+    // queues a draw command; shader/texture are GL object IDs (0 if the command binds its own)
+    void Submit(unsigned int layer, BlendMode blend, unsigned int shader, unsigned int texture, std::function<void()> draw);
+    // sorts and executes all queued commands, then restores the default (premultiplied) blend state
+    void Flush();
+    // resets the statistics
+    void ResetStats();
+
+private:
+    struct SortEntry
+    {
+        uint64_t Key;
+        unsigned int Index;
+    };
+    std::vector<RenderCommand> commands;
+    std::vector<SortEntry> entries, scratch;
+    // LSD radix sort of entries by key, 8 bits per pass; passes whose digit is equal for all keys are skipped
+    void sort();
+    // applies the given blend mode
+    static void applyBlend(BlendMode blend);
+};
+
+
+#endif //PROJEKT1_RENDERQUEUE_H
@@ -0,0 +1,77 @@
+#include "RenderTargetPool.h"
+#include "GLStateCache.h"
+
+#include <iostream>
+
+
+RenderTargetPool::RenderTargetPool()
+    : Allocations(0)
+{
+}
+
+RenderTargetPool::~RenderTargetPool()
+{
+    for (RenderTarget *target : this->targets)
+        destroy(target);
+}
+
+RenderTarget *RenderTargetPool::Acquire(unsigned int width, unsigned int height, GLenum format, GLenum wrap)
+{
+    for (RenderTarget *target : this->targets)
+    {
+        if (!target->InUse && target->Width == width && target->Height == height && target->Format == format
+            && target->Wrap == wrap)
+        {
+            target->InUse = true;
+            target->IdleFrames = 0;
+            return target;
+        }
+    }
+    // nothing free with this key, create a new target
+    RenderTarget *target = new RenderTarget();
+    target->Width = width;
+    target->Height = height;
+    target->Format = format;
+    target->Wrap = wrap;
+    target->InUse = true;
+    target->IdleFrames = 0;
+    target->Texture.Internal_Format = format;
+    target->Texture.Image_Format = GL_RGBA;
+    target->Texture.Wrap_S = wrap;
+    target->Texture.Wrap_T = wrap;
+    target->Texture.Generate(width, height, NULL);
+    glGenFramebuffers(1, &target->FBO);
+    GLStateCache::BindFramebuffer(GL_FRAMEBUFFER, target->FBO);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, target->Texture.ID, 0);
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+        std::cout << "ERROR::RENDERTARGETPOOL: Failed to initialize " << width << "x" << height << " target" << std::endl;
+    GLStateCache::BindFramebuffer(GL_FRAMEBUFFER, 0);
+    this->targets.push_back(target);
+    ++this->Allocations;
+    return target;
+}
+
+void RenderTargetPool::Release(RenderTarget *target)
+{
+    target->InUse = false;
+}
+
+void RenderTargetPool::EndFrame(unsigned int maxIdleFrames)
+{
+    unsigned int kept = 0;
+    for (RenderTarget *target : this->targets)
+    {
+        if (!target->InUse && ++target->IdleFrames > maxIdleFrames)
+            destroy(target);
+        else
+            this->targets[kept++] = target;
+    }
+    this->targets.resize(kept);
+}
+
+void RenderTargetPool::destroy(RenderTarget *target)
+{
+    GLStateCache::DeleteFramebuffer(target->FBO);
+    GLStateCache::DeleteTexture(target->Texture.ID);
+    delete target;
+}
@@ -0,0 +1,55 @@
+#ifndef PROJEKT1_RENDERTARGETPOOL_H
+#define PROJEKT1_RENDERTARGETPOOL_H
+
+#include <vector>
+
+#include <glad/glad.h>
+
+#include "Texture2D.h"
+
+
+// An offscreen color buffer: a texture and the framebuffer it is attached to
+struct RenderTarget
+{
+    unsigned int FBO;
+    Texture2D    Texture;
+    unsigned int Width, Height;
+    GLenum       Format; // internal format of Texture
+    GLenum       Wrap;   // wrap mode of Texture on both axes
+    // pool bookkeeping
+    bool         InUse;
+    unsigned int IdleFrames;
+};
+
+
+// RenderTargetPool hands out intermediate render targets for multi-pass
+// effects. Targets are keyed by size, internal format and wrap: Acquire()
+// reuses a released target with the same key and only creates one when
+// none is free, so a pass chain stops allocating after its first frame.
+// Targets nobody acquired for a while are deleted by EndFrame().
+class RenderTargetPool
+{
+public:
+    // number of targets created since construction
+    unsigned int Allocations;
+    // constructor/destructor
+    RenderTargetPool();
+    ~RenderTargetPool();
+    // returns a free target of the given size, internal format and wrap mode (contents undefined);
+    // effects sample across the edges, so targets clamp unless asked to wrap around
+    RenderTarget *Acquire(unsigned int width, unsigned int height, GLenum format, GLenum wrap = GL_CLAMP_TO_EDGE);
+    // returns a target to the pool
+    void Release(RenderTarget *target);
+    // deletes targets that have not been acquired for maxIdleFrames frames; call once per frame
+    void EndFrame(unsigned int maxIdleFrames = 120);
+    // number of targets currently allocated
+    unsigned int Size() const { return static_cast<unsigned int>(this->targets.size()); }
+
+private:
+    std::vector<RenderTarget *> targets;
+    // frees the GL objects of a target
+    static void destroy(RenderTarget *target);
+};
+
+
+#endif //PROJEKT1_RENDERTARGETPOOL_H
@@ -1,33 +1,249 @@
 #include "ResourceManager.h"
+#include "GLStateCache.h"
 
+#include <algorithm>
+#include <cstring>
 #include <iostream>
 #include <sstream>
 #include <fstream>
+#include <set>
 #define STB_IMAGE_IMPLEMENTATION
 #include "../headers/stb_image.h"
 
 // Instantiate static variables
 std::map<std::string, Texture2D>    ResourceManager::Textures;
 std::map<std::string, Shader>       ResourceManager::Shaders;
+std::vector<Texture2D>              ResourceManager::AtlasPages;
+std::vector<ResourceManager::AtlasEntry> ResourceManager::atlasQueue;
+std::map<std::string, ResourceManager::ShaderFiles> ResourceManager::shaderFiles;
 
+// border (in pixels) around every atlas region; filled with the region's edge pixels so linear filtering never bleeds into a neighbour
+static const int ATLAS_PADDING = 2;
 
-Shader ResourceManager::LoadShader(const char *vShaderFile, const char *fShaderFile, const char *gShaderFile, std::string name)
+// multiplies the color of count RGBA8 pixels by their alpha; every texture with alpha is stored premultiplied,
+// which is what the single GL_ONE, GL_ONE_MINUS_SRC_ALPHA blend mode of the renderers expects
+static void premultiplyAlpha(unsigned char *pixels, int count)
 {
-    Shaders[name] = loadShaderFromFile(vShaderFile, fShaderFile, gShaderFile);
+    for (int i = 0; i < count; ++i)
+    {
+        unsigned char *pixel = pixels + i * 4;
+        for (int c = 0; c < 3; ++c)
+            pixel[c] = static_cast<unsigned char>((pixel[c] * pixel[3] + 127) / 255);
+    }
+}
+
+
+// inserts a #define line per define after the #version line (which has to stay the first statement) of source
+static std::string addDefines(const std::string &source, const std::vector<std::string> &defines)
+{
+    if (defines.empty())
+        return source;
+    std::string lines;
+    for (const std::string &define : defines)
+        lines += "#define " + define + "\n";
+    size_t version = source.find("#version");
+    size_t lineEnd = version == std::string::npos ? std::string::npos : source.find('\n', version);
+    if (lineEnd == std::string::npos)
+        return lines + source;
+    return source.substr(0, lineEnd + 1) + lines + source.substr(lineEnd + 1);
+}
+
+Shader ResourceManager::LoadShader(const char *vShaderFile, const char *fShaderFile, const char *gShaderFile, std::string name,
+                                   const std::vector<std::string> &defines)
+{
+    Shaders[name] = loadShaderFromFile(vShaderFile, fShaderFile, gShaderFile, defines);
+    shaderFiles[name] = { vShaderFile, fShaderFile, gShaderFile != nullptr ? gShaderFile : "" };
     return Shaders[name];
 }
 
+Shader ResourceManager::LoadFeedbackShader(const char *vShaderFile, const std::vector<std::string> &varyings, std::string name)
+{
+    std::ifstream vertexShaderFile(vShaderFile);
+    if (!vertexShaderFile)
+        std::cout << "ERROR::SHADER: Failed to read shader files" << std::endl;
+    std::stringstream vShaderStream;
+    vShaderStream << vertexShaderFile.rdbuf();
+    Shader shader;
+    shader.CompileFeedback(vShaderStream.str().c_str(), varyings);
+    Shaders[name] = shader;
+    return shader;
+}
+
 Shader& ResourceManager::GetShader(std::string name)
 {
     return Shaders[name];
 }
 
+Shader& ResourceManager::GetShaderVariant(std::string name, const std::vector<std::string> &defines)
+{
+    if (defines.empty())
+        return Shaders[name];
+    // variants are stored next to their shader as name[DEFINE,DEFINE]
+    std::string key = name + "[";
+    for (unsigned int i = 0; i < defines.size(); ++i)
+        key += (i > 0 ? "," : "") + defines[i];
+    key += "]";
+    auto variant = Shaders.find(key);
+    if (variant != Shaders.end())
+        return variant->second;
+    auto files = shaderFiles.find(name);
+    if (files == shaderFiles.end())
+    {
+        std::cout << "ERROR::SHADER: No files to build variant " << key << " from" << std::endl;
+        return Shaders[name];
+    }
+    const ShaderFiles &source = files->second;
+    Shaders[key] = loadShaderFromFile(source.Vertex.c_str(), source.Fragment.c_str(),
+                                      source.Geometry.empty() ? nullptr : source.Geometry.c_str(), defines);
+    return Shaders[key];
+}
+
 Texture2D ResourceManager::LoadTexture(const char *file, bool alpha, std::string name)
 {
     Textures[name] = loadTextureFromFile(file, alpha);
     return Textures[name];
 }
 
+void ResourceManager::AddToAtlas(const char *file, bool alpha, std::string name)
+{
+    atlasQueue.push_back({ file, name, alpha });
+}
+
+void ResourceManager::BuildAtlas(unsigned int pageSize)
+{
+    // never exceed what the driver supports
+    int maxSize;
+    glGetIntegerv(GL_MAX_TEXTURE_SIZE, &maxSize);
+    pageSize = std::min(pageSize, static_cast<unsigned int>(maxSize));
+    // load all queued images as RGBA
+    struct Image
+    {
+        const AtlasEntry *entry;
+        int width, height;
+        unsigned char *data;
+        unsigned int page;
+        int x, y;
+    };
+    std::vector<Image> images;
+    for (const AtlasEntry &entry : atlasQueue)
+    {
+        Image image = { &entry, 0, 0, nullptr, 0, 0, 0 };
+        int nrChannels;
+        image.data = stbi_load(entry.File.c_str(), &image.width, &image.height, &nrChannels, 4);
+        if (!image.data)
+        {
+            std::cout << "ERROR::ATLAS: Failed to load " << entry.File << std::endl;
+            continue;
+        }
+        // textures loaded without alpha are treated as fully opaque
+        if (!entry.Alpha)
+            for (int i = 0; i < image.width * image.height; ++i)
+                image.data[i * 4 + 3] = 255;
+        else
+            premultiplyAlpha(image.data, image.width * image.height);
+        images.push_back(image);
+    }
+    // shelf packing: place the tallest images first, filling rows left to right
+    std::vector<Image*> sorted;
+    for (Image &image : images)
+        sorted.push_back(&image);
+    std::stable_sort(sorted.begin(), sorted.end(), [](const Image *a, const Image *b) { return a->height > b->height; });
+    struct Page
+    {
+        int width, height;
+        int shelfX, shelfY, shelfHeight;
+    };
+    std::vector<Page> pages;
+    const int size = static_cast<int>(pageSize);
+    for (Image *image : sorted)
+    {
+        int w = image->width + 2 * ATLAS_PADDING, h = image->height + 2 * ATLAS_PADDING;
+        if (w > size || h > size)
+        {
+            // too large for a shared page, give it a page of its own
+            image->page = pages.size();
+            image->x = image->y = ATLAS_PADDING;
+            pages.push_back({ w, h, w, 0, h });
+            continue;
+        }
+        bool placed = false;
+        for (unsigned int p = 0; p < pages.size() && !placed; ++p)
+        {
+            Page &page = pages[p];
+            if (page.width != size)
+                continue; // dedicated page
+            if (page.shelfX + w > size) // start a new shelf below the current one
+            {
+                page.shelfY += page.shelfHeight;
+                page.shelfX = 0;
+                page.shelfHeight = 0;
+            }
+            if (page.shelfY + h > size)
+                continue;
+            image->page = p;
+            image->x = page.shelfX + ATLAS_PADDING;
+            image->y = page.shelfY + ATLAS_PADDING;
+            page.shelfX += w;
+            page.shelfHeight = std::max(page.shelfHeight, h);
+            placed = true;
+        }
+        if (!placed)
+        {
+            image->page = pages.size();
+            image->x = image->y = ATLAS_PADDING;
+            pages.push_back({ size, size, w, 0, h });
+        }
+    }
+    // compose and upload every page, then register the regions
+    for (unsigned int p = 0; p < pages.size(); ++p)
+    {
+        Page &page = pages[p];
+        // shrink shared pages to the area actually used
+        if (page.width == size)
+            page.height = std::min(size, page.shelfY + page.shelfHeight);
+        std::vector<unsigned char> pixels(page.width * page.height * 4, 0);
+        for (const Image &image : images)
+        {
+            if (image.page != p)
+                continue;
+            // copy the image and extrude its edge pixels into the padding border
+            for (int y = -ATLAS_PADDING; y < image.height + ATLAS_PADDING; ++y)
+            {
+                int srcY = std::min(std::max(y, 0), image.height - 1);
+                for (int x = -ATLAS_PADDING; x < image.width + ATLAS_PADDING; ++x)
+                {
+                    int srcX = std::min(std::max(x, 0), image.width - 1);
+                    std::memcpy(&pixels[((image.y + y) * page.width + image.x + x) * 4],
+                                &image.data[(srcY * image.width + srcX) * 4], 4);
+                }
+            }
+        }
+        Texture2D texture;
+        texture.Internal_Format = GL_RGBA;
+        texture.Image_Format = GL_RGBA;
+        texture.Wrap_S = GL_CLAMP_TO_EDGE;
+        texture.Wrap_T = GL_CLAMP_TO_EDGE;
+        texture.Generate(page.width, page.height, pixels.data());
+        AtlasPages.push_back(texture);
+
+        for (const Image &image : images)
+        {
+            if (image.page != p)
+                continue;
+            Texture2D region = texture;
+            region.Width = image.width;
+            region.Height = image.height;
+            region.UV = glm::vec4(image.x / static_cast<float>(page.width), image.y / static_cast<float>(page.height),
+                                  (image.x + image.width) / static_cast<float>(page.width),
+                                  (image.y + image.height) / static_cast<float>(page.height));
+            Textures[image.entry->Name] = region;
+        }
+    }
+    for (Image &image : images)
+        stbi_image_free(image.data);
+    atlasQueue.clear();
+}
+
 Texture2D& ResourceManager::GetTexture(std::string name)
 {
     return Textures[name];
@@ -37,13 +253,19 @@ void ResourceManager::Clear()
 {
     // (properly) delete all shaders
     for (auto iter : Shaders)
-        glDeleteProgram(iter.second.ID);
-    // (properly) delete all textures
+        GLStateCache::DeleteProgram(iter.second.ID);
+    // (properly) delete all textures; atlas regions share their page's texture object
+    std::set<unsigned int> textures;
     for (auto iter : Textures)
-        glDeleteTextures(1, &iter.second.ID);
+        textures.insert(iter.second.ID);
+    for (const Texture2D &page : AtlasPages)
+        textures.insert(page.ID);
+    for (unsigned int id : textures)
+        GLStateCache::DeleteTexture(id);
 }
 
-Shader ResourceManager::loadShaderFromFile(const char *vShaderFile, const char *fShaderFile, const char *gShaderFile)
+Shader ResourceManager::loadShaderFromFile(const char *vShaderFile, const char *fShaderFile, const char *gShaderFile,
+                                           const std::vector<std::string> &defines)
 {
     // 1. retrieve the vertex/fragment source code from filePath
     std::string vertexCode;
@@ -62,8 +284,8 @@ Shader ResourceManager::loadShaderFromFile(const char *vShaderFile, const char *
         vertexShaderFile.close();
         fragmentShaderFile.close();
         // convert stream into string
-        vertexCode = vShaderStream.str();
-        fragmentCode = fShaderStream.str();
+        vertexCode = addDefines(vShaderStream.str(), defines);
+        fragmentCode = addDefines(fShaderStream.str(), defines);
         // if geometry shader path is present, also load a geometry shader
         if (gShaderFile != nullptr)
         {
@@ -71,7 +293,7 @@ Shader ResourceManager::loadShaderFromFile(const char *vShaderFile, const char *
             std::stringstream gShaderStream;
             gShaderStream << geometryShaderFile.rdbuf();
             geometryShaderFile.close();
-            geometryCode = gShaderStream.str();
+            geometryCode = addDefines(gShaderStream.str(), defines);
         }
     }
     catch (std::exception e)
@@ -99,6 +321,8 @@ Texture2D ResourceManager::loadTextureFromFile(const char *file, bool alpha)
     // load image
     int width, height, nrChannels;
     unsigned char* data = stbi_load(file, &width, &height, &nrChannels, 0);
+    if (data && alpha && nrChannels == 4)
+        premultiplyAlpha(data, width * height);
     // now generate texture
     texture.Generate(width, height, data);
     // and finally free image data
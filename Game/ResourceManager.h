@@ -3,6 +3,7 @@
 
 #include <map>
 #include <string>
+#include <vector>
 
 #include <glad/glad.h>
 
@@ -21,12 +22,25 @@ public:
     // resource storage
     static std::map<std::string, Shader>    Shaders;
     static std::map<std::string, Texture2D> Textures;
-    // loads (and generates) a shader program from file loading vertex, fragment (and geometry) shader's source code. If gShaderFile is not nullptr, it also loads a geometry shader
-    static Shader    LoadShader(const char *vShaderFile, const char *fShaderFile, const char *gShaderFile, std::string name);
+    // texture objects backing the atlas regions stored in Textures
+    static std::vector<Texture2D>           AtlasPages;
+    // loads (and generates) a shader program from file loading vertex, fragment (and geometry) shader's source code. If gShaderFile is not nullptr, it also loads a geometry shader.
+    // Every define is inserted as a #define line after the #version line of each stage
+    static Shader    LoadShader(const char *vShaderFile, const char *fShaderFile, const char *gShaderFile, std::string name,
+                                const std::vector<std::string> &defines = {});
+    // loads (and generates) a vertex-only transform feedback program capturing the given outputs
+    static Shader    LoadFeedbackShader(const char *vShaderFile, const std::vector<std::string> &varyings, std::string name);
     // retrieves a stored sader
     static Shader    &GetShader(std::string name);
-    // loads (and generates) a texture from file
+    // retrieves the permutation of a shader loaded by LoadShader built from the same files with the given defines;
+    // compiled on first request and cached, an empty define list is the shader itself
+    static Shader    &GetShaderVariant(std::string name, const std::vector<std::string> &defines);
+    // loads (and generates) a texture from file; textures with alpha are premultiplied
     static Texture2D LoadTexture(const char *file, bool alpha, std::string name);
+    // queues a texture file to be packed into the texture atlas by BuildAtlas
+    static void      AddToAtlas(const char *file, bool alpha, std::string name);
+    // rect-packs all queued textures into one or more atlas pages; every queued name becomes a texture region with its own UV bounds
+    static void      BuildAtlas(unsigned int pageSize = 2048);
     // retrieves a stored texture
     static Texture2D &GetTexture(std::string name);
     // properly de-allocates all loaded resources
@@ -35,9 +49,23 @@ private:
     // private constructor, that is we do not want any actual resource manager objects. Its members and functions should be publicly available (static).
     ResourceManager() { }
     // loads and generates a shader from file
-    static Shader    loadShaderFromFile(const char *vShaderFile, const char *fShaderFile, const char *gShaderFile = nullptr);
-    // loads a single texture from file
+    static Shader    loadShaderFromFile(const char *vShaderFile, const char *fShaderFile, const char *gShaderFile = nullptr,
+                                        const std::vector<std::string> &defines = {});
+    // loads a single texture from file, premultiplying its color by alpha
     static Texture2D loadTextureFromFile(const char *file, bool alpha);
+    // texture files waiting to be packed by BuildAtlas
+    struct AtlasEntry
+    {
+        std::string File, Name;
+        bool Alpha;
+    };
+    static std::vector<AtlasEntry> atlasQueue;
+    // source files of the shaders loaded by LoadShader, to compile their variants from
+    struct ShaderFiles
+    {
+        std::string Vertex, Fragment, Geometry; // Geometry is empty if there is none
+    };
+    static std::map<std::string, ShaderFiles> shaderFiles;
 };
 
 #endif
@@ -0,0 +1,64 @@
+#include "RibbonTrail.h"
+#include "GLStateCache.h"
+
+#include <algorithm>
+#include <cmath>
+
+// uniform handles
+static constexpr uint32_t POINTS = UniformId("points");
+static constexpr uint32_t HEAD = UniformId("head");
+static constexpr uint32_t COUNT = UniformId("count");
+static constexpr uint32_t RING_SIZE = UniformId("ringSize");
+static constexpr uint32_t RIBBON_COLOR = UniformId("ribbonColor");
+static constexpr uint32_t RIBBON_WIDTH = UniformId("ribbonWidth");
+
+
+RibbonTrail::RibbonTrail(unsigned int length, float interval)
+    : points(std::min(std::max(length, 2u), RIBBON_MAX_POINTS)), head(0), count(0), interval(interval), elapsed(0.0f)
+{
+}
+
+void RibbonTrail::Record(glm::vec2 position, float dt)
+{
+    this->elapsed += dt;
+    if (this->count == 0 || this->elapsed >= this->interval)
+    {
+        // start a new point, the oldest one drops off the end of the ring
+        this->elapsed = this->count == 0 ? 0.0f : std::fmod(this->elapsed, this->interval);
+        this->head = (this->head + 1) % this->points.size();
+        this->count = std::min(this->count + 1, static_cast<unsigned int>(this->points.size()));
+    }
+    this->points[this->head] = position;
+}
+
+void RibbonTrail::Clear()
+{
+    this->count = 0;
+    this->elapsed = 0.0f;
+}
+
+RibbonRenderer::RibbonRenderer(Shader shader)
+    : shader(shader)
+{
+    glGenVertexArrays(1, &this->VAO);
+}
+
+RibbonRenderer::~RibbonRenderer()
+{
+    GLStateCache::DeleteVertexArray(this->VAO);
+}
+
+void RibbonRenderer::Draw(const RibbonTrail &trail, glm::vec3 color, float width)
+{
+    if (trail.count < 2)
+        return;
+    this->shader.Use();
+    this->shader.SetVector2fv(POINTS, trail.points.data(), static_cast<int>(trail.points.size()));
+    this->shader.SetInteger(HEAD, static_cast<int>(trail.head));
+    this->shader.SetInteger(COUNT, static_cast<int>(trail.count));
+    this->shader.SetInteger(RING_SIZE, static_cast<int>(trail.points.size()));
+    this->shader.SetVector3f(RIBBON_COLOR, color);
+    this->shader.SetFloat(RIBBON_WIDTH, width);
+    GLStateCache::BindVertexArray(this->VAO);
+    glDrawArrays(GL_TRIANGLE_STRIP, 0, trail.count * 2);
+}
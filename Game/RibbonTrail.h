@@ -0,0 +1,63 @@
+#ifndef PROJEKT1_RIBBONTRAIL_H
+#define PROJEKT1_RIBBONTRAIL_H
+
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "Shader.h"
+
+
+// longest ribbon (in points) RibbonRenderer can draw, the size of the point array in ribbon.vs
+const unsigned int RIBBON_MAX_POINTS = 64;
+
+
+// RibbonTrail records where an object has recently been: a ring of its
+// positions sampled every interval seconds, the newest one following the
+// object continuously. When the object stops, the older points catch up
+// with it one by one and the ribbon shrinks away.
+class RibbonTrail
+{
+public:
+    // constructor; length is the number of points kept (at most RIBBON_MAX_POINTS)
+    explicit RibbonTrail(unsigned int length = 24, float interval = 1.0f / 60.0f);
+    // moves the trail's head to position, starting a new point every interval seconds
+    void Record(glm::vec2 position, float dt);
+    // forgets all points, e.g. when the object is teleported
+    void Clear();
+    // number of recorded points
+    unsigned int Count() const { return this->count; }
+
+private:
+    friend class RibbonRenderer;
+    std::vector<glm::vec2> points; // ring of positions
+    unsigned int head;             // index of the newest point
+    unsigned int count;
+    float interval, elapsed;
+};
+
+
+// RibbonRenderer draws RibbonTrails as triangle strips tapering from the
+// object to the end of the trail. It has no vertex buffers: the trail's
+// point ring is uploaded as a uniform array and ribbon.vs expands two
+// vertices per point from gl_VertexID, so a trail costs one draw call and
+// a few hundred bytes of uniforms, and only covers the pixels it shows.
+class RibbonRenderer
+{
+public:
+    // constructor/destructor
+    explicit RibbonRenderer(Shader shader);
+    ~RibbonRenderer();
+    // draws the trail width pixels wide at its head; expects premultiplied blending (GL_ONE, GL_ONE_MINUS_SRC_ALPHA), the output is additive
+    void Draw(const RibbonTrail &trail, glm::vec3 color, float width);
+
+private:
+    Shader shader;
+    unsigned int VAO; // empty, core profile needs one bound to draw
+    // disable copying, the vertex array is owned
+    RibbonRenderer(const RibbonRenderer &) = delete;
+    RibbonRenderer &operator=(const RibbonRenderer &) = delete;
+};
+
+
+#endif //PROJEKT1_RIBBONTRAIL_H
@@ -1,10 +1,13 @@
 #include "Shader.h"
+#include "GLStateCache.h"
 
 #include <iostream>
 
+#include "FrameData.h"
+
 Shader &Shader::Use()
 {
-    glUseProgram(this->ID);
+    GLStateCache::UseProgram(this->ID);
     return *this;
 }
 
@@ -35,8 +38,7 @@ void Shader::Compile(const char* vertexSource, const char* fragmentSource, const
     glAttachShader(this->ID, sFragment);
     if (geometrySource != nullptr)
         glAttachShader(this->ID, gShader);
-    glLinkProgram(this->ID);
-    checkCompileErrors(this->ID, "PROGRAM");
+    this->link();
     // delete the shaders as they're linked into our program now and no longer necessary
     glDeleteShader(sVertex);
     glDeleteShader(sFragment);
@@ -44,61 +46,169 @@ void Shader::Compile(const char* vertexSource, const char* fragmentSource, const
         glDeleteShader(gShader);
 }
 
+void Shader::CompileFeedback(const char *vertexSource, const std::vector<std::string> &varyings)
+{
+    unsigned int sVertex = glCreateShader(GL_VERTEX_SHADER);
+    glShaderSource(sVertex, 1, &vertexSource, NULL);
+    glCompileShader(sVertex);
+    checkCompileErrors(sVertex, "VERTEX");
+    this->ID = glCreateProgram();
+    glAttachShader(this->ID, sVertex);
+    // the captured outputs have to be declared before linking
+    std::vector<const char *> names;
+    for (const std::string &varying : varyings)
+        names.push_back(varying.c_str());
+    glTransformFeedbackVaryings(this->ID, static_cast<GLsizei>(names.size()), names.data(), GL_INTERLEAVED_ATTRIBS);
+    this->link();
+    glDeleteShader(sVertex);
+}
+
+int Shader::Location(uint32_t id) const
+{
+    for (const UniformSlot &slot : this->uniforms)
+        if (slot.Id == id)
+            return slot.Location;
+    return -1;
+}
+
 void Shader::SetFloat(const char *name, float value, bool useShader)
+{
+    this->SetFloat(UniformId(name), value, useShader);
+}
+void Shader::SetInteger(const char *name, int value, bool useShader)
+{
+    this->SetInteger(UniformId(name), value, useShader);
+}
+void Shader::SetVector2f(const char *name, float x, float y, bool useShader)
+{
+    this->SetVector2f(UniformId(name), x, y, useShader);
+}
+void Shader::SetVector2f(const char *name, const glm::vec2 &value, bool useShader)
+{
+    this->SetVector2f(UniformId(name), value, useShader);
+}
+void Shader::SetVector2fv(const char *name, const glm::vec2 *values, int count, bool useShader)
+{
+    this->SetVector2fv(UniformId(name), values, count, useShader);
+}
+void Shader::SetVector3f(const char *name, float x, float y, float z, bool useShader)
+{
+    this->SetVector3f(UniformId(name), x, y, z, useShader);
+}
+void Shader::SetVector3f(const char *name, const glm::vec3 &value, bool useShader)
+{
+    this->SetVector3f(UniformId(name), value, useShader);
+}
+void Shader::SetVector4f(const char *name, float x, float y, float z, float w, bool useShader)
+{
+    this->SetVector4f(UniformId(name), x, y, z, w, useShader);
+}
+void Shader::SetVector4f(const char *name, const glm::vec4 &value, bool useShader)
+{
+    this->SetVector4f(UniformId(name), value, useShader);
+}
+void Shader::SetMatrix4(const char *name, const glm::mat4 &matrix, bool useShader)
+{
+    this->SetMatrix4(UniformId(name), matrix, useShader);
+}
+
+void Shader::SetFloat(uint32_t id, float value, bool useShader)
 {
     if (useShader)
         this->Use();
-    glUniform1f(glGetUniformLocation(this->ID, name), value);
+    glUniform1f(this->Location(id), value);
 }
-void Shader::SetInteger(const char *name, int value, bool useShader)
+void Shader::SetInteger(uint32_t id, int value, bool useShader)
 {
     if (useShader)
         this->Use();
-    glUniform1i(glGetUniformLocation(this->ID, name), value);
+    glUniform1i(this->Location(id), value);
 }
-void Shader::SetVector2f(const char *name, float x, float y, bool useShader)
+void Shader::SetVector2f(uint32_t id, float x, float y, bool useShader)
 {
     if (useShader)
         this->Use();
-    glUniform2f(glGetUniformLocation(this->ID, name), x, y);
+    glUniform2f(this->Location(id), x, y);
 }
-void Shader::SetVector2f(const char *name, const glm::vec2 &value, bool useShader)
+void Shader::SetVector2f(uint32_t id, const glm::vec2 &value, bool useShader)
 {
     if (useShader)
         this->Use();
-    glUniform2f(glGetUniformLocation(this->ID, name), value.x, value.y);
+    glUniform2f(this->Location(id), value.x, value.y);
 }
-void Shader::SetVector3f(const char *name, float x, float y, float z, bool useShader)
+void Shader::SetVector2fv(uint32_t id, const glm::vec2 *values, int count, bool useShader)
 {
     if (useShader)
         this->Use();
-    glUniform3f(glGetUniformLocation(this->ID, name), x, y, z);
+    glUniform2fv(this->Location(id), count, glm::value_ptr(values[0]));
 }
-void Shader::SetVector3f(const char *name, const glm::vec3 &value, bool useShader)
+void Shader::SetVector3f(uint32_t id, float x, float y, float z, bool useShader)
 {
     if (useShader)
         this->Use();
-    glUniform3f(glGetUniformLocation(this->ID, name), value.x, value.y, value.z);
+    glUniform3f(this->Location(id), x, y, z);
 }
-void Shader::SetVector4f(const char *name, float x, float y, float z, float w, bool useShader)
+void Shader::SetVector3f(uint32_t id, const glm::vec3 &value, bool useShader)
 {
     if (useShader)
         this->Use();
-    glUniform4f(glGetUniformLocation(this->ID, name), x, y, z, w);
+    glUniform3f(this->Location(id), value.x, value.y, value.z);
 }
-void Shader::SetVector4f(const char *name, const glm::vec4 &value, bool useShader)
+void Shader::SetVector4f(uint32_t id, float x, float y, float z, float w, bool useShader)
 {
     if (useShader)
         this->Use();
-    glUniform4f(glGetUniformLocation(this->ID, name), value.x, value.y, value.z, value.w);
+    glUniform4f(this->Location(id), x, y, z, w);
 }
-void Shader::SetMatrix4(const char *name, const glm::mat4 &matrix, bool useShader)
+void Shader::SetVector4f(uint32_t id, const glm::vec4 &value, bool useShader)
+{
+    if (useShader)
+        this->Use();
+    glUniform4f(this->Location(id), value.x, value.y, value.z, value.w);
+}
+void Shader::SetMatrix4(uint32_t id, const glm::mat4 &matrix, bool useShader)
 {
     if (useShader)
         this->Use();
-    glUniformMatrix4fv(glGetUniformLocation(this->ID, name), 1, false, glm::value_ptr(matrix));
+    glUniformMatrix4fv(this->Location(id), 1, false, glm::value_ptr(matrix));
+}
+
+void Shader::cacheUniforms()
+{
+    this->uniforms.clear();
+    int count, maxLength;
+    glGetProgramiv(this->ID, GL_ACTIVE_UNIFORMS, &count);
+    glGetProgramiv(this->ID, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxLength);
+    std::vector<char> buffer(maxLength + 1);
+    for (int i = 0; i < count; ++i)
+    {
+        int length, size;
+        unsigned int type;
+        glGetActiveUniform(this->ID, i, static_cast<int>(buffer.size()), &length, &size, &type, buffer.data());
+        std::string name(buffer.data(), length);
+        int location = glGetUniformLocation(this->ID, name.c_str());
+        if (location < 0)
+            continue; // member of a uniform block
+        // arrays are reported as "name[0]"; make them available under their plain name
+        if (name.size() > 3 && name.compare(name.size() - 3, 3, "[0]") == 0)
+            name.resize(name.size() - 3);
+        uint32_t id = UniformId(name.c_str());
+        if (this->Location(id) != -1)
+            std::cout << "| ERROR::SHADER: Uniform name hash collision: " << name << std::endl;
+        this->uniforms.push_back({ id, location });
+    }
 }
 
+void Shader::link()
+{
+    glLinkProgram(this->ID);
+    checkCompileErrors(this->ID, "PROGRAM");
+    this->cacheUniforms();
+    // programs reading the shared per-frame data get it from the FrameData binding point
+    unsigned int frameData = glGetUniformBlockIndex(this->ID, "FrameData");
+    if (frameData != GL_INVALID_INDEX)
+        glUniformBlockBinding(this->ID, frameData, FRAME_DATA_BINDING);
+}
 
 void Shader::checkCompileErrors(unsigned int object, std::string type)
 {
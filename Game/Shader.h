@@ -1,13 +1,23 @@
 #ifndef SHADER_H
 #define SHADER_H
 
+#include <cstdint>
 #include <string>
+#include <vector>
 
 #include <glad/glad.h>
 #include <glm/glm.hpp>
 #include <glm/gtc/type_ptr.hpp>
 
 
+// Compile-time FNV-1a hash of a uniform name. Shader uses it as the
+// handle of a uniform, e.g. static constexpr uint32_t OFFSET = UniformId("offset");
+constexpr uint32_t UniformId(const char *name, uint32_t hash = 2166136261u)
+{
+    return *name == '\0' ? hash : UniformId(name + 1, (hash ^ static_cast<unsigned char>(*name)) * 16777619u);
+}
+
+
 // General purpose shader object. Compiles from file, generates
 // compile/link-time error messages and hosts several utility
 // functions for easy management.
@@ -22,19 +32,46 @@ public:
     Shader  &Use();
     // compiles the shader from given source code
     void    Compile(const char *vertexSource, const char *fragmentSource, const char *geometrySource = nullptr); // note: geometry source code is optional
-    // utility functions
+    // compiles a vertex-only program whose outputs are captured (interleaved, in the given order) with transform feedback
+    void    CompileFeedback(const char *vertexSource, const std::vector<std::string> &varyings);
+    // returns the location of an active uniform (-1 if there is none), looked up in the table built at link time
+    int     Location(uint32_t id) const;
+    // utility functions; uniforms are passed by name or by UniformId handle, neither queries the driver
     void    SetFloat    (const char *name, float value, bool useShader = false);
     void    SetInteger  (const char *name, int value, bool useShader = false);
     void    SetVector2f (const char *name, float x, float y, bool useShader = false);
     void    SetVector2f (const char *name, const glm::vec2 &value, bool useShader = false);
+    void    SetVector2fv(const char *name, const glm::vec2 *values, int count, bool useShader = false);
     void    SetVector3f (const char *name, float x, float y, float z, bool useShader = false);
     void    SetVector3f (const char *name, const glm::vec3 &value, bool useShader = false);
     void    SetVector4f (const char *name, float x, float y, float z, float w, bool useShader = false);
     void    SetVector4f (const char *name, const glm::vec4 &value, bool useShader = false);
     void    SetMatrix4  (const char *name, const glm::mat4 &matrix, bool useShader = false);
+    void    SetFloat    (uint32_t id, float value, bool useShader = false);
+    void    SetInteger  (uint32_t id, int value, bool useShader = false);
+    void    SetVector2f (uint32_t id, float x, float y, bool useShader = false);
+    void    SetVector2f (uint32_t id, const glm::vec2 &value, bool useShader = false);
+    void    SetVector2fv(uint32_t id, const glm::vec2 *values, int count, bool useShader = false);
+    void    SetVector3f (uint32_t id, float x, float y, float z, bool useShader = false);
+    void    SetVector3f (uint32_t id, const glm::vec3 &value, bool useShader = false);
+    void    SetVector4f (uint32_t id, float x, float y, float z, float w, bool useShader = false);
+    void    SetVector4f (uint32_t id, const glm::vec4 &value, bool useShader = false);
+    void    SetMatrix4  (uint32_t id, const glm::mat4 &matrix, bool useShader = false);
 private:
+    // location of an active uniform, keyed by the hash of its name
+    struct UniformSlot
+    {
+        uint32_t Id;
+        int      Location;
+    };
+    // flat table of all active uniforms, built after linking
+    std::vector<UniformSlot> uniforms;
+    // links the attached shaders and sets up the uniform table and block bindings
+    void    link();
     // checks if compilation or linking failed and if so, print the error logs
     void    checkCompileErrors(unsigned int object, std::string type);
+    // enumerates the active uniforms of the linked program into the uniform table
+    void    cacheUniforms();
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,148 @@
+#include "SpriteBatch.h"
+#include "GLStateCache.h"
+
+#include <algorithm>
+#include <cstddef>
+
+
+SpriteBatch::SpriteBatch(Shader &shader, Shader &unrotatedShader, unsigned int capacity)
+    : DrawCalls(0), Sprites(0), shader(shader), unrotatedShader(unrotatedShader),
+      instanceStream(capacity * sizeof(SpriteInstance))
+{
+    this->initRenderData();
+}
+
+SpriteBatch::~SpriteBatch()
+{
+    GLStateCache::DeleteVertexArray(this->quadVAO);
+    GLStateCache::DeleteBuffer(this->quadVBO);
+}
+
+void SpriteBatch::Begin()
+{
+    this->instances.clear();
+    this->groups.clear();
+}
+
+void SpriteBatch::Submit(const Texture2D &texture, glm::vec2 position, glm::vec2 size, float rotate, glm::vec3 color, float alpha)
+{
+    this->instances.push_back({ glm::vec4(position, size), rotate, glm::vec4(color, alpha), texture.UV });
+    this->groups.push_back((static_cast<uint64_t>(rotate != 0.0f) << 32) | texture.ID);
+}
+
+void SpriteBatch::Flush()
+{
+    this->Sprites += static_cast<unsigned int>(this->instances.size());
+    if (this->instances.empty())
+        return;
+    // group instances per rotation variant and texture (stable, so sprites of the same group keep their order)
+    this->order.resize(this->instances.size());
+    for (unsigned int i = 0; i < this->order.size(); ++i)
+        this->order[i] = i;
+    std::stable_sort(this->order.begin(), this->order.end(),
+                     [this](unsigned int a, unsigned int b) { return this->groups[a] < this->groups[b]; });
+    // write the instances in group order straight into the stream buffer
+    GLintptr offset;
+    SpriteInstance *mapped = static_cast<SpriteInstance *>(
+        this->instanceStream.Map(this->order.size() * sizeof(SpriteInstance), offset));
+    for (unsigned int i = 0; i < this->order.size(); ++i)
+        mapped[i] = this->instances[this->order[i]];
+    this->instanceStream.Unmap();
+    // draw one instanced quad per group
+    GLStateCache::BindVertexArray(this->quadVAO);
+    unsigned int first = 0;
+    while (first < this->order.size())
+    {
+        uint64_t group = this->groups[this->order[first]];
+        unsigned int last = first + 1;
+        while (last < this->order.size() && this->groups[this->order[last]] == group)
+            ++last;
+        // unrotated sprites come first; the program only changes once per flush
+        if (first == 0 || (group >> 32) != (this->groups[this->order[first - 1]] >> 32))
+            ((group >> 32) ? this->shader : this->unrotatedShader).Use();
+        unsigned int textureID = static_cast<unsigned int>(group & 0xFFFFFFFF);
+        // point the instance attributes at the start of this run (no base instance in GL 3.3)
+        GLStateCache::BindBuffer(GL_ARRAY_BUFFER, this->instanceStream.ID);
+        setInstanceAttributes(offset + first * sizeof(SpriteInstance));
+
+        GLStateCache::BindTexture(textureID);
+        glDrawArraysInstanced(GL_TRIANGLES, 0, 6, last - first);
+        ++this->DrawCalls;
+        first = last;
+    }
+}
+
+unsigned int SpriteBatch::CreateInstanceArray(unsigned int buffer, GLintptr offset) const
+{
+    unsigned int VAO;
+    glGenVertexArrays(1, &VAO);
+    GLStateCache::BindVertexArray(VAO);
+    GLStateCache::BindBuffer(GL_ARRAY_BUFFER, this->quadVBO);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)0);
+    GLStateCache::BindBuffer(GL_ARRAY_BUFFER, buffer);
+    setInstanceAttributes(offset);
+    GLStateCache::BindBuffer(GL_ARRAY_BUFFER, 0);
+    GLStateCache::BindVertexArray(0);
+    return VAO;
+}
+
+void SpriteBatch::DrawInstances(unsigned int vertexArray, unsigned int textureID, unsigned int count, bool rotated)
+{
+    (rotated ? this->shader : this->unrotatedShader).Use();
+    GLStateCache::BindTexture(textureID);
+    GLStateCache::BindVertexArray(vertexArray);
+    glDrawArraysInstanced(GL_TRIANGLES, 0, 6, count);
+    ++this->DrawCalls;
+    this->Sprites += count;
+}
+
+void SpriteBatch::ResetStats()
+{
+    this->DrawCalls = 0;
+    this->Sprites = 0;
+}
+
+void SpriteBatch::initRenderData()
+{
+    // configure VAO/VBO, same unit quad as SpriteRenderer
+    float vertices[] = {
+            // pos      // tex
+            0.0f, 1.0f, 0.0f, 1.0f,
+            1.0f, 0.0f, 1.0f, 0.0f,
+            0.0f, 0.0f, 0.0f, 0.0f,
+
+            0.0f, 1.0f, 0.0f, 1.0f,
+            1.0f, 1.0f, 1.0f, 1.0f,
+            1.0f, 0.0f, 1.0f, 0.0f
+    };
+
+    glGenVertexArrays(1, &this->quadVAO);
+    glGenBuffers(1, &this->quadVBO);
+
+    GLStateCache::BindVertexArray(this->quadVAO);
+    // per-vertex quad
+    GLStateCache::BindBuffer(GL_ARRAY_BUFFER, this->quadVBO);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)0);
+    // the per-instance attributes are pointed at the stream buffer on every Flush()
+    GLStateCache::BindBuffer(GL_ARRAY_BUFFER, 0);
+    GLStateCache::BindVertexArray(0);
+}
+
+void SpriteBatch::setInstanceAttributes(GLintptr offset)
+{
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, sizeof(SpriteInstance), (void*)(offset + offsetof(SpriteInstance, Rect)));
+    glVertexAttribDivisor(1, 1);
+    glEnableVertexAttribArray(2);
+    glVertexAttribPointer(2, 1, GL_FLOAT, GL_FALSE, sizeof(SpriteInstance), (void*)(offset + offsetof(SpriteInstance, Rotation)));
+    glVertexAttribDivisor(2, 1);
+    glEnableVertexAttribArray(3);
+    glVertexAttribPointer(3, 4, GL_FLOAT, GL_FALSE, sizeof(SpriteInstance), (void*)(offset + offsetof(SpriteInstance, Color)));
+    glVertexAttribDivisor(3, 1);
+    glEnableVertexAttribArray(4);
+    glVertexAttribPointer(4, 4, GL_FLOAT, GL_FALSE, sizeof(SpriteInstance), (void*)(offset + offsetof(SpriteInstance, UV)));
+    glVertexAttribDivisor(4, 1);
+}
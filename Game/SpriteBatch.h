@@ -0,0 +1,74 @@
+#ifndef PROJEKT1_SPRITEBATCH_H
+#define PROJEKT1_SPRITEBATCH_H
+
+#include <cstdint>
+#include <vector>
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+#include "Shader.h"
+#include "StreamBuffer.h"
+#include "Texture2D.h"
+
+
+// Per-instance data of a single batched sprite, laid out exactly as it
+// is uploaded into the instance buffer.
+struct SpriteInstance
+{
+    glm::vec4 Rect;     // <vec2 position, vec2 size>
+    float     Rotation; // in degrees, around the center of the quad
+    glm::vec4 Color;    // rgb tints the (premultiplied) texture, a scales its coverage: 1 blends, 0 adds
+    glm::vec4 UV;       // <vec2 min, vec2 max> texture region
+};
+
+
+// SpriteBatch collects sprites between Begin() and Flush() and renders
+// every sprite that shares a texture with a single instanced draw call.
+// Sprites are grouped per texture (and into unrotated/rotated sprites,
+// which use different shader variants) on Flush(), so draw order is only
+// preserved between sprites of the same group; start a new batch for
+// anything that has to be layered on top.
+class SpriteBatch
+{
+public:
+    // statistics since the last ResetStats()
+    unsigned int DrawCalls, Sprites;
+    // constructor/destructor, capacity is the number of sprites per frame the stream buffer starts out with
+    SpriteBatch(Shader &shader, Shader &unrotatedShader, unsigned int capacity = 1024);
+    ~SpriteBatch();
+    // starts collecting a new batch of sprites
+    void Begin();
+    // queues a sprite for rendering, same arguments as SpriteRenderer::DrawSprite; an alpha of 0 draws the sprite
+    // additively, so glowing and alpha blended sprites of one texture still share a draw call
+    void Submit(const Texture2D &texture, glm::vec2 position,
+                glm::vec2 size = glm::vec2(10.0f, 10.0f), float rotate = 0.0f,
+                glm::vec3 color = glm::vec3(1.0f), float alpha = 1.0f);
+    // renders all queued sprites, one instanced draw call per texture
+    void Flush();
+    // creates a vertex array that renders the batch quad with SpriteInstance data read from buffer, starting at byte offset;
+    // lets owners of retained instance buffers draw with the batch's shader
+    unsigned int CreateInstanceArray(unsigned int buffer, GLintptr offset = 0) const;
+    // renders count instances from a vertex array made by CreateInstanceArray (independent of Begin()/Flush());
+    // pass rotated = false if none of the instances are rotated to skip the rotation math
+    void DrawInstances(unsigned int vertexArray, unsigned int textureID, unsigned int count, bool rotated = false);
+    // resets the draw statistics
+    void ResetStats();
+
+private:
+    // render state
+    Shader shader, unrotatedShader;
+    unsigned int quadVAO, quadVBO;
+    StreamBuffer instanceStream;
+    // batch state
+    std::vector<SpriteInstance> instances;
+    std::vector<uint64_t>       groups;   // <rotated, texture ID> group of each queued instance
+    std::vector<unsigned int>   order;    // instance indices sorted by group
+    // initializes buffers and vertex attributes
+    void initRenderData();
+    // points the per-instance attributes of the bound vertex array at the bound GL_ARRAY_BUFFER, starting at byte offset
+    static void setInstanceAttributes(GLintptr offset);
+};
+
+
+#endif //PROJEKT1_SPRITEBATCH_H
@@ -3,44 +3,41 @@
 //
 
 #include "SpriteRenderer.h"
+#include "GLStateCache.h"
 
 
 
-SpriteRenderer::SpriteRenderer(Shader &shader)
+SpriteRenderer::SpriteRenderer(Shader &shader, Shader &unrotatedShader)
 {
     this->shader = shader;
+    this->unrotatedShader = unrotatedShader;
     this->initRenderData();
 }
 
 SpriteRenderer::~SpriteRenderer()
 {
-    glDeleteVertexArrays(1, &this->quadVAO);
+    GLStateCache::DeleteVertexArray(this->quadVAO);
 }
 
-void SpriteRenderer::DrawSprite(Texture2D &texture, glm::vec2 position, glm::vec2 size, float rotate, glm::vec3 color)
+void SpriteRenderer::DrawSprite(Texture2D &texture, glm::vec2 position, glm::vec2 size, float rotate, glm::vec3 color, float alpha)
 {
-    // prepare transformations
-    this->shader.Use();
-    glm::mat4 model = glm::mat4(1.0f);
-    model = glm::translate(model, glm::vec3(position, 0.0f));  // first translate (transformations are: scale happens first, then rotation, and then final translation happens; reversed order)
-
-    model = glm::translate(model, glm::vec3(0.5f * size.x, 0.5f * size.y, 0.0f)); // move origin of rotation to center of quad
-    model = glm::rotate(model, glm::radians(rotate), glm::vec3(0.0f, 0.0f, 1.0f)); // then rotate
-    model = glm::translate(model, glm::vec3(-0.5f * size.x, -0.5f * size.y, 0.0f)); // move origin back
-
-    model = glm::scale(model, glm::vec3(size, 1.0f)); // last scale
-
-    this->shader.SetMatrix4("model", model);
+    // the shader builds the transformation (scale, rotate around the center, translate) from these attributes;
+    // the quad's vertex array has no arrays enabled for them, so the constant values apply to all vertices
+    if (rotate == 0.0f)
+        this->unrotatedShader.Use();
+    else
+        this->shader.Use();
+    glVertexAttrib4f(1, position.x, position.y, size.x, size.y);
+    glVertexAttrib1f(2, rotate);
+    glVertexAttrib4f(3, color.r, color.g, color.b, alpha);
+    glVertexAttrib4f(4, texture.UV.x, texture.UV.y, texture.UV.z, texture.UV.w);
 
     // render textured quad
-    this->shader.SetVector3f("spriteColor", color);
 
-    glActiveTexture(GL_TEXTURE0);
     texture.Bind();
 
-    glBindVertexArray(this->quadVAO);
+    GLStateCache::BindVertexArray(this->quadVAO);
     glDrawArrays(GL_TRIANGLES, 0, 6);
-    glBindVertexArray(0);
 }
 
 void SpriteRenderer::initRenderData()
@@ -61,12 +58,12 @@ void SpriteRenderer::initRenderData()
     glGenVertexArrays(1, &this->quadVAO);
     glGenBuffers(1, &VBO);
 
-    glBindBuffer(GL_ARRAY_BUFFER, VBO);
+    GLStateCache::BindBuffer(GL_ARRAY_BUFFER, VBO);
     glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
 
-    glBindVertexArray(this->quadVAO);
+    GLStateCache::BindVertexArray(this->quadVAO);
     glEnableVertexAttribArray(0);
     glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)0);
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
-    glBindVertexArray(0);
+    GLStateCache::BindBuffer(GL_ARRAY_BUFFER, 0);
+    GLStateCache::BindVertexArray(0);
 }
\ No newline at end of file
@@ -10,18 +10,22 @@
 #include "glm/vec3.hpp"
 #include "Texture2D.h"
 
+// Renders single sprites. Position, size, rotation and color are passed
+// as constant vertex attributes and the quad is expanded in sprite.vs,
+// so no model matrix is built or uploaded per sprite; unrotated sprites
+// use a shader variant that skips the rotation entirely.
 class SpriteRenderer {
 public:
-    explicit SpriteRenderer(Shader &shader);
+    SpriteRenderer(Shader &shader, Shader &unrotatedShader);
 
     ~SpriteRenderer();
 
     void DrawSprite(Texture2D &texture, glm::vec2 position,
                     glm::vec2 size = glm::vec2(10.0f, 10.0f), float rotate = 0.0f,
-                    glm::vec3 color = glm::vec3(1.0f));
+                    glm::vec3 color = glm::vec3(1.0f), float alpha = 1.0f);
 
 private:
-    Shader shader;
+    Shader shader, unrotatedShader;
     unsigned int quadVAO;
 
     void initRenderData();
@@ -0,0 +1,120 @@
+#include "StreamBuffer.h"
+#include "GLStateCache.h"
+
+#include <algorithm>
+#include <iostream>
+
+
+// Instantiate static variables
+std::vector<StreamBuffer *> StreamBuffer::buffers;
+
+
+StreamBuffer::StreamBuffer(GLsizeiptr regionSize, unsigned int regions)
+    : ID(0), Persistent(false), regionSize(regionSize), head(0), regions(regions), current(0),
+      fences(regions, nullptr), mapped(nullptr)
+{
+    this->Persistent = GLAD_GL_VERSION_4_4 || GLAD_GL_ARB_buffer_storage;
+    this->allocate();
+    buffers.push_back(this);
+}
+
+StreamBuffer::~StreamBuffer()
+{
+    buffers.erase(std::find(buffers.begin(), buffers.end(), this));
+    this->release();
+}
+
+void *StreamBuffer::Map(GLsizeiptr size, GLintptr &offset)
+{
+    GLsizeiptr aligned = (size + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+    if (this->head + aligned > this->regionSize)
+    {
+        // this frame needs more room than a region holds: start over in a bigger buffer,
+        // draws already issued keep the old buffer object alive until they are done
+        while (this->regionSize < this->head + aligned)
+            this->regionSize *= 2;
+        this->release();
+        this->allocate();
+    }
+    offset = this->current * this->regionSize + this->head;
+    this->head += aligned;
+    if (this->Persistent)
+        return this->mapped + offset;
+    GLStateCache::BindBuffer(GL_ARRAY_BUFFER, this->ID);
+    return glMapBufferRange(GL_ARRAY_BUFFER, offset, size,
+                            GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT);
+}
+
+void StreamBuffer::Unmap()
+{
+    // persistent mappings are coherent, nothing to flush
+    if (this->Persistent)
+        return;
+    GLStateCache::BindBuffer(GL_ARRAY_BUFFER, this->ID);
+    glUnmapBuffer(GL_ARRAY_BUFFER);
+}
+
+void StreamBuffer::EndFrame()
+{
+    for (StreamBuffer *buffer : buffers)
+        buffer->advance();
+}
+
+void StreamBuffer::allocate()
+{
+    GLsizeiptr size = this->regionSize * this->regions;
+    glGenBuffers(1, &this->ID);
+    GLStateCache::BindBuffer(GL_ARRAY_BUFFER, this->ID);
+    if (this->Persistent)
+    {
+        GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+        glBufferStorage(GL_ARRAY_BUFFER, size, nullptr, flags);
+        this->mapped = static_cast<char *>(glMapBufferRange(GL_ARRAY_BUFFER, 0, size, flags));
+    }
+    else
+        glBufferData(GL_ARRAY_BUFFER, size, nullptr, GL_STREAM_DRAW);
+    this->current = 0;
+    this->head = 0;
+}
+
+void StreamBuffer::release()
+{
+    for (GLsync &fence : this->fences)
+    {
+        if (fence)
+            glDeleteSync(fence);
+        fence = nullptr;
+    }
+    // deleting a buffer also unmaps it
+    GLStateCache::DeleteBuffer(this->ID);
+    this->mapped = nullptr;
+}
+
+void StreamBuffer::advance()
+{
+    if (this->head == 0)
+        return;
+    this->head = 0;
+    if (!this->Persistent)
+    {
+        // let the driver hand out fresh storage once the ring wraps instead of waiting for the old one
+        this->current = (this->current + 1) % this->regions;
+        if (this->current == 0)
+        {
+            GLStateCache::BindBuffer(GL_ARRAY_BUFFER, this->ID);
+            glBufferData(GL_ARRAY_BUFFER, this->regionSize * this->regions, nullptr, GL_STREAM_DRAW);
+        }
+        return;
+    }
+    // the GPU is done with this region once the fence is signaled
+    this->fences[this->current] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    this->current = (this->current + 1) % this->regions;
+    GLsync &fence = this->fences[this->current];
+    if (fence == nullptr)
+        return;
+    GLenum result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000);
+    if (result == GL_WAIT_FAILED || result == GL_TIMEOUT_EXPIRED)
+        std::cout << "ERROR::STREAMBUFFER: waiting for a region failed" << std::endl;
+    glDeleteSync(fence);
+    fence = nullptr;
+}
@@ -0,0 +1,59 @@
+#ifndef PROJEKT1_STREAMBUFFER_H
+#define PROJEKT1_STREAMBUFFER_H
+
+#include <vector>
+
+#include <glad/glad.h>
+
+
+// StreamBuffer is a vertex buffer for data that is rewritten every frame.
+// It is split into (by default three) regions, one per frame in flight:
+// a frame appends into its region with Map()/Unmap() and EndFrame()
+// fences it and moves every stream buffer on to its next region, waiting
+// only if the GPU is still reading that region from frames ago.
+// With GL 4.4 / ARB_buffer_storage the buffer is mapped persistently once
+// and Map() just hands out pointers; on plain GL 3.3 every Map() maps the
+// range unsynchronized and the buffer is orphaned whenever the ring wraps.
+// Regions grow (into a new buffer) if a frame writes more than they hold,
+// so always read ID after Map() and point vertex attributes at it then.
+class StreamBuffer
+{
+public:
+    // buffer object the last Map() wrote into
+    unsigned int ID;
+    // whether the buffer is persistently mapped
+    bool Persistent;
+    // constructor/destructor
+    StreamBuffer(GLsizeiptr regionSize, unsigned int regions = 3);
+    ~StreamBuffer();
+    // reserves size bytes of the current frame's region and returns where to write them;
+    // offset receives their byte offset into ID. Call Unmap() before drawing from them
+    void *Map(GLsizeiptr size, GLintptr &offset);
+    // finishes the writes of the last Map()
+    void Unmap();
+    // fences the regions written this frame and moves every stream buffer on to its next region;
+    // call once per frame after the last draw call
+    static void EndFrame();
+
+private:
+    // offsets handed out by Map() are aligned to this many bytes
+    static const GLsizeiptr ALIGNMENT = 64;
+    // all live stream buffers, advanced by EndFrame()
+    static std::vector<StreamBuffer *> buffers;
+    GLsizeiptr regionSize, head;
+    unsigned int regions, current;
+    std::vector<GLsync> fences; // one per region, nullptr if the region is free
+    char *mapped;               // persistent mapping of the whole buffer
+    // disable copying, the buffer object and its mapping are owned
+    StreamBuffer(const StreamBuffer &) = delete;
+    StreamBuffer &operator=(const StreamBuffer &) = delete;
+    // (re)creates the buffer object with the current region size
+    void allocate();
+    // releases the buffer object and pending fences
+    void release();
+    // fences the current region and waits until the next one is free
+    void advance();
+};
+
+
+#endif //PROJEKT1_STREAMBUFFER_H
@@ -6,6 +6,9 @@
 #include FT_FREETYPE_H
 #include FT_GLYPH_H
 #include "TextRenderer.h"
+#include "GLStateCache.h"
+#include <algorithm>
+#include <cstring>
 #include <iostream>
 
 
@@ -15,41 +18,61 @@
 
 #include "ResourceManager.h"
 
+// uniform handles
+static constexpr uint32_t TEXT_COLOR = UniformId("textColor");
 
-TextRenderer::TextRenderer(unsigned int width, unsigned int height)
+
+// number of glyphs per frame the vertex stream starts out with
+static const unsigned int GLYPH_CAPACITY = 1024;
+static const GLsizeiptr GLYPH_SIZE = sizeof(float) * 6 * 4;
+
+
+TextRenderer::TextRenderer()
+    : vertexStream(GLYPH_CAPACITY * GLYPH_SIZE), fontSize(0), glyphSize(0)
 {
     // load and configure shader
     this->TextShader = ResourceManager::LoadShader("resources/shaders/Game/text_2d.vs",
                                                    "resources/shaders/Game/text_2d.fs", nullptr, "text");
-    this->TextShader.SetMatrix4("projection",
-                                glm::ortho(0.0f, static_cast<float>(width), static_cast<float>(height), 0.0f), true);
-    this->TextShader.SetInteger("text", 0);
-    // configure VAO/VBO for texture quads
+    // the projection comes from the FrameData block
+    this->TextShader.SetInteger("text", 0, true);
+    // configure VAO for texture quads, the vertex attribute is pointed at the stream buffer per string
     glGenVertexArrays(1, &this->VAO);
-    glGenBuffers(1, &this->VBO);
-    glBindVertexArray(this->VAO);
-    glBindBuffer(GL_ARRAY_BUFFER, this->VBO);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(float) * 6 * 4, NULL, GL_DYNAMIC_DRAW);
+    GLStateCache::BindVertexArray(this->VAO);
     glEnableVertexAttribArray(0);
-    glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, 4 * sizeof(float), 0);
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
-    glBindVertexArray(0);
+    GLStateCache::BindVertexArray(0);
 }
 
 void TextRenderer::Load(std::string font, unsigned int fontSize)
+{
+    this->font = font;
+    this->fontSize = fontSize;
+    this->loadGlyphs(fontSize);
+}
+
+void TextRenderer::SetResolution(float resolution)
+{
+    unsigned int pixelSize = std::max(1u, static_cast<unsigned int>(this->fontSize * resolution + 0.5f));
+    if (pixelSize != this->glyphSize)
+        this->loadGlyphs(pixelSize);
+}
+
+void TextRenderer::loadGlyphs(unsigned int pixelSize)
 {
     // first clear the previously loaded Characters
+    for (auto &character : this->Characters)
+        GLStateCache::DeleteTexture(character.second.TextureID);
     this->Characters.clear();
+    this->glyphSize = pixelSize;
     // then initialize and load the FreeType library
     FT_Library ft;
     if (FT_Init_FreeType(&ft)) // all functions return a value different than 0 whenever an error occurred
         std::cout << "ERROR::FREETYPE: Could not init FreeType Library" << std::endl;
     // load font as face
     FT_Face face;
-    if (FT_New_Face(ft, font.c_str(), 0, &face))
+    if (FT_New_Face(ft, this->font.c_str(), 0, &face))
         std::cout << "ERROR::FREETYPE: Failed to load font" << std::endl;
     // set size to load glyphs as
-    FT_Set_Pixel_Sizes(face, 0, fontSize);
+    FT_Set_Pixel_Sizes(face, 0, pixelSize);
     // disable byte-alignment restriction
     glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
     // then for the first 128 ASCII characters, pre-load/compile their characters and store them
@@ -64,7 +87,7 @@ void TextRenderer::Load(std::string font, unsigned int fontSize)
         // generate texture
         unsigned int texture;
         glGenTextures(1, &texture);
-        glBindTexture(GL_TEXTURE_2D, texture);
+        GLStateCache::BindTexture(texture);
         glTexImage2D(
             GL_TEXTURE_2D,
             0,
@@ -91,7 +114,7 @@ void TextRenderer::Load(std::string font, unsigned int fontSize)
         };
         Characters.insert(std::pair<char, Character>(c, character));
     }
-    glBindTexture(GL_TEXTURE_2D, 0);
+    GLStateCache::BindTexture(0);
     // destroy FreeType once we're finished
     FT_Done_Face(face);
     FT_Done_FreeType(ft);
@@ -99,25 +122,24 @@ void TextRenderer::Load(std::string font, unsigned int fontSize)
 
 void TextRenderer::RenderText(std::string text, float x, float y, float scale, glm::vec3 color)
 {
-    // activate corresponding render state
-    this->TextShader.Use();
-    this->TextShader.SetVector3f("textColor", color);
-    glActiveTexture(GL_TEXTURE0);
-    glBindVertexArray(this->VAO);
-
-    // iterate through all characters
-    std::string::const_iterator c;
-    for (c = text.begin(); c != text.end(); c++)
+    if (text.empty())
+        return;
+    // glyph metrics are in pixels of the rasterized size, scale is relative to the loaded one
+    scale *= static_cast<float>(this->fontSize) / this->glyphSize;
+    // write the quads of all characters straight into the stream buffer
+    GLintptr offset;
+    float (*vertices)[6][4] = static_cast<float (*)[6][4]>(this->vertexStream.Map(text.size() * GLYPH_SIZE, offset));
+    float baseline = this->Characters['H'].Bearing.y;
+    for (unsigned int i = 0; i < text.size(); ++i)
     {
-        Character ch = Characters[*c];
+        Character ch = Characters[text[i]];
 
         float xpos = x + ch.Bearing.x * scale;
-        float ypos = y + (this->Characters['H'].Bearing.y - ch.Bearing.y) * scale;
+        float ypos = y + (baseline - ch.Bearing.y) * scale;
 
         float w = ch.Size.x * scale;
         float h = ch.Size.y * scale;
-        // update VBO for each character
-        float vertices[6][4] = {
+        float quad[6][4] = {
             {xpos, ypos + h, 0.0f, 1.0f},
             {xpos + w, ypos, 1.0f, 0.0f},
             {xpos, ypos, 0.0f, 0.0f},
@@ -126,18 +148,22 @@ void TextRenderer::RenderText(std::string text, float x, float y, float scale, g
             {xpos + w, ypos + h, 1.0f, 1.0f},
             {xpos + w, ypos, 1.0f, 0.0f}
         };
-        // render glyph texture over quad
-        glBindTexture(GL_TEXTURE_2D, ch.TextureID);
-        // update content of VBO memory
-        glBindBuffer(GL_ARRAY_BUFFER, this->VBO);
-        glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(vertices), vertices);
-        // be sure to use glBufferSubData and not glBufferData
-        glBindBuffer(GL_ARRAY_BUFFER, 0);
-        // render quad
-        glDrawArrays(GL_TRIANGLES, 0, 6);
+        std::memcpy(vertices[i], quad, sizeof(quad));
         // now advance cursors for next glyph
         x += (ch.Advance >> 6) * scale; // bitshift by 6 to get value in pixels (1/64th times 2^6 = 64)
     }
-    glBindVertexArray(0);
-    glBindTexture(GL_TEXTURE_2D, 0);
+    this->vertexStream.Unmap();
+
+    // activate corresponding render state
+    this->TextShader.Use();
+    this->TextShader.SetVector3f(TEXT_COLOR, color);
+    GLStateCache::BindVertexArray(this->VAO);
+    GLStateCache::BindBuffer(GL_ARRAY_BUFFER, this->vertexStream.ID);
+    glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)offset);
+    // render one glyph texture per quad
+    for (unsigned int i = 0; i < text.size(); ++i)
+    {
+        GLStateCache::BindTexture(this->Characters[text[i]].TextureID);
+        glDrawArrays(GL_TRIANGLES, i * 6, 6);
+    }
 }
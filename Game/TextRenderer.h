@@ -18,6 +18,7 @@
 
 #include "Texture2D.h"
 #include "Shader.h"
+#include "StreamBuffer.h"
 
 
 /// Holds all state information relevant to a character as loaded using FreeType
@@ -40,16 +41,23 @@ public:
     std::map<char, Character> Characters;
     // shader used for text rendering
     Shader TextShader;
-    // constructor
-    TextRenderer(unsigned int width, unsigned int height);
-    // pre-compiles a list of characters from the given font
+    // constructor; the projection comes from the FrameData block
+    TextRenderer();
+    // pre-compiles a list of characters from the given font; fontSize is also the size RenderText's scale is relative to
     void Load(std::string font, unsigned int fontSize);
+    // reloads the glyphs at resolution times the loaded font size; text keeps its size on screen
+    void SetResolution(float resolution);
     // renders a string of text using the precompiled list of characters
     void RenderText(std::string text, float x, float y, float scale, glm::vec3 color = glm::vec3(1.0f));
 
 private:
     // render state
-    unsigned int VAO, VBO;
+    unsigned int VAO;
+    StreamBuffer vertexStream; // glyph quads of every string rendered this frame
+    std::string font;
+    unsigned int fontSize, glyphSize; // size passed to Load / size the glyphs are rasterized at
+    // rasterizes the glyphs of the current font at the given pixel size
+    void loadGlyphs(unsigned int pixelSize);
 };
 
 #endif //TEXTRENDERER_H
@@ -1,10 +1,11 @@
 #include <iostream>
 
 #include "Texture2D.h"
+#include "GLStateCache.h"
 
 
 Texture2D::Texture2D()
-        : Width(0), Height(0), Internal_Format(GL_RGB), Image_Format(GL_RGB), Wrap_S(GL_REPEAT), Wrap_T(GL_REPEAT), Filter_Min(GL_LINEAR), Filter_Max(GL_LINEAR)
+        : Width(0), Height(0), Internal_Format(GL_RGB), Image_Format(GL_RGB), Wrap_S(GL_REPEAT), Wrap_T(GL_REPEAT), Filter_Min(GL_LINEAR), Filter_Max(GL_LINEAR), UV(0.0f, 0.0f, 1.0f, 1.0f)
 {
     glGenTextures(1, &this->ID);
 }
@@ -14,7 +15,7 @@ void Texture2D::Generate(unsigned int width, unsigned int height, unsigned char*
     this->Width = width;
     this->Height = height;
     // create Texture
-    glBindTexture(GL_TEXTURE_2D, this->ID);
+    GLStateCache::BindTexture(this->ID);
     glTexImage2D(GL_TEXTURE_2D, 0, this->Internal_Format, width, height, 0, this->Image_Format, GL_UNSIGNED_BYTE, data);
     // set Texture wrap and filter modes
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, this->Wrap_S);
@@ -22,10 +23,10 @@ void Texture2D::Generate(unsigned int width, unsigned int height, unsigned char*
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, this->Filter_Min);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, this->Filter_Max);
     // unbind texture
-    glBindTexture(GL_TEXTURE_2D, 0);
+    GLStateCache::BindTexture(0);
 }
 
 void Texture2D::Bind() const
 {
-    glBindTexture(GL_TEXTURE_2D, this->ID);
+    GLStateCache::BindTexture(this->ID);
 }
\ No newline at end of file
@@ -2,6 +2,7 @@
 #define TEXTURE_H
 
 #include <glad/glad.h>
+#include <glm/glm.hpp>
 
 // Texture2D is able to store and configure a texture in OpenGL.
 // It also hosts utility functions for easy management.
@@ -20,6 +21,8 @@ public:
     unsigned int Wrap_T; // wrapping mode on T axis
     unsigned int Filter_Min; // filtering mode if texture pixels < screen pixels
     unsigned int Filter_Max; // filtering mode if texture pixels > screen pixels
+    // region of the texture object this texture covers <vec2 min, vec2 max> in texture coordinates (a sub-rectangle for atlas regions)
+    glm::vec4 UV;
     // constructor (sets default texture modes)
     Texture2D();
     // generates texture from image data
@@ -0,0 +1,70 @@
+#include "ThreadPool.h"
+
+
+ThreadPool::ThreadPool(unsigned int threads)
+    : job(nullptr), count(0), next(0), busy(0), generation(0), stopping(false)
+{
+    for (unsigned int i = 0; i < threads; ++i)
+        this->workers.emplace_back(&ThreadPool::work, this);
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        this->stopping = true;
+    }
+    this->wake.notify_all();
+    for (std::thread &worker : this->workers)
+        worker.join();
+}
+
+void ThreadPool::Run(unsigned int count, const std::function<void(unsigned int)> &job)
+{
+    // not worth waking anyone up for
+    if (this->workers.empty() || count <= 1)
+    {
+        for (unsigned int i = 0; i < count; ++i)
+            job(i);
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        this->job = &job;
+        this->count = count;
+        this->next = 0;
+        this->busy = static_cast<unsigned int>(this->workers.size());
+        ++this->generation;
+    }
+    this->wake.notify_all();
+    // the calling thread helps out instead of just waiting
+    this->drain();
+    std::unique_lock<std::mutex> lock(this->mutex);
+    this->done.wait(lock, [this]() { return this->busy == 0; });
+    this->job = nullptr;
+}
+
+void ThreadPool::work()
+{
+    unsigned int seen = 0;
+    std::unique_lock<std::mutex> lock(this->mutex);
+    while (true)
+    {
+        this->wake.wait(lock, [this, seen]() { return this->stopping || this->generation != seen; });
+        if (this->stopping)
+            return;
+        seen = this->generation;
+        lock.unlock();
+        this->drain();
+        lock.lock();
+        if (--this->busy == 0)
+            this->done.notify_one();
+    }
+}
+
+void ThreadPool::drain()
+{
+    unsigned int i;
+    while ((i = this->next.fetch_add(1)) < this->count)
+        (*this->job)(i);
+}
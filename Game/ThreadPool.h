@@ -0,0 +1,48 @@
+#ifndef PROJEKT1_THREADPOOL_H
+#define PROJEKT1_THREADPOOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+
+// ThreadPool keeps a fixed set of worker threads around for data-parallel
+// jobs. Run() hands out the indices of a job one at a time to the workers
+// and the calling thread, and returns once all of them are processed, so
+// a job only has to make sure that different indices touch different data.
+class ThreadPool
+{
+public:
+    // constructor/destructor; threads is the number of workers besides the calling thread
+    explicit ThreadPool(unsigned int threads);
+    ~ThreadPool();
+    // number of threads Run() spreads work over, including the calling one
+    unsigned int Threads() const { return static_cast<unsigned int>(this->workers.size()) + 1; }
+    // calls job(i) for every i in [0, count) and waits until all calls returned
+    void Run(unsigned int count, const std::function<void(unsigned int)> &job);
+
+private:
+    std::vector<std::thread> workers;
+    std::mutex mutex;
+    std::condition_variable wake, done;
+    // the job being run; only written while no worker is busy
+    const std::function<void(unsigned int)> *job;
+    unsigned int count;
+    std::atomic<unsigned int> next;  // next index to hand out
+    unsigned int busy;               // workers that haven't finished the current job
+    unsigned int generation;         // bumped for every job, wakes the workers
+    bool stopping;
+    // disable copying, the threads are owned
+    ThreadPool(const ThreadPool &) = delete;
+    ThreadPool &operator=(const ThreadPool &) = delete;
+    // worker thread main loop
+    void work();
+    // processes indices of the current job until there are none left
+    void drain();
+};
+
+
+#endif //PROJEKT1_THREADPOOL_H
@@ -0,0 +1,26 @@
+#version 330 core
+layout (location = 0) in vec4 vertex; // <vec2 position, vec2 texCoords>
+layout (location = 1) in vec4 instancePositionVelocity; // particle state written by particle_update.vs
+layout (location = 2) in vec4 instanceColor;
+layout (location = 3) in vec2 instanceLifeSize;
+
+out vec2 TexCoords;
+out vec4 ParticleColor;
+
+layout (std140) uniform FrameData
+{
+    mat4  projection;
+    vec2  viewportSize;
+    float time;
+};
+uniform vec4 uvRect; // <vec2 min, vec2 max> texture region, e.g. inside an atlas
+
+void main()
+{
+    // dead particles collapse into a zero-sized quad
+    float size = instanceLifeSize.x > 0.0 ? instanceLifeSize.y : 0.0;
+    TexCoords = mix(uvRect.xy, uvRect.zw, vertex.zw);
+    // premultiplied and additive like the CPU particles (the fade can run below zero before the particle dies)
+    ParticleColor = vec4(instanceColor.rgb * max(instanceColor.a, 0.0), 0.0);
+    gl_Position = projection * vec4((vertex.xy * size) + instancePositionVelocity.xy, 0.0, 1.0);
+}
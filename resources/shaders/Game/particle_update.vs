@@ -0,0 +1,27 @@
+#version 330 core
+// Advances one particle per vertex; the outputs are captured with transform
+// feedback into the other buffer. Mirrors UpdateParticles in ParticleKernels.cpp.
+layout (location = 0) in vec4 positionVelocity; // <vec2 position, vec2 velocity>
+layout (location = 1) in vec4 color;
+layout (location = 2) in vec2 lifeSize;         // <float life, float size>
+
+out vec4 outPositionVelocity;
+out vec4 outColor;
+out vec2 outLifeSize;
+
+uniform float deltaTime;
+
+const float FADE_RATE = 2.5; // alpha lost per second of life
+
+void main()
+{
+    float life = lifeSize.x - deltaTime;
+    outPositionVelocity = positionVelocity;
+    outColor = color;
+    if (life > 0.0)
+    {   // particle is alive, thus update
+        outPositionVelocity.xy -= positionVelocity.zw * deltaTime;
+        outColor.a -= deltaTime * FADE_RATE;
+    }
+    outLifeSize = vec2(life, lifeSize.y);
+}
@@ -0,0 +1,71 @@
+#version 330 core
+in  vec2  TexCoords;
+out vec4  color;
+
+// one pass of the PostProcessor effect chain, selected by a define:
+// BLUR (one direction of a separable gaussian), DOWNSAMPLE (optionally with BRIGHT_PASS), UPSAMPLE, EDGE or INVERT
+uniform sampler2D source;
+uniform vec2      texelSize; // 1 / size of source
+
+#ifdef BLUR
+uniform vec2  direction; // (1, 0) or (0, 1)
+uniform int   radius;    // texels sampled on each side of the center
+uniform float sigma;
+#endif
+#ifdef BRIGHT_PASS
+uniform float threshold;
+#endif
+#ifdef UPSAMPLE
+uniform float intensity;
+#endif
+
+void main()
+{
+#if defined(BLUR)
+    // gaussian weights of texel pairs (i, i + 1), fetched with one bilinear sample placed between them by weight
+    vec2 step = direction * texelSize;
+    float falloff = -0.5 / (sigma * sigma);
+    float total = 1.0;
+    vec3 sum = texture(source, TexCoords).rgb;
+    for (int i = 1; i <= radius; i += 2)
+    {
+        float near = exp(falloff * float(i * i));
+        float far = i < radius ? exp(falloff * float((i + 1) * (i + 1))) : 0.0;
+        float weight = near + far;
+        vec2 offset = step * (float(i) + far / weight);
+        sum += (texture(source, TexCoords + offset).rgb + texture(source, TexCoords - offset).rgb) * weight;
+        total += 2.0 * weight;
+    }
+    color = vec4(sum / total, 1.0);
+#elif defined(DOWNSAMPLE)
+    // 4 bilinear taps average the 4x4 source texels under the half-sized target texel
+    vec3 sum = texture(source, TexCoords + texelSize * vec2(-1.0, -1.0)).rgb
+             + texture(source, TexCoords + texelSize * vec2( 1.0, -1.0)).rgb
+             + texture(source, TexCoords + texelSize * vec2(-1.0,  1.0)).rgb
+             + texture(source, TexCoords + texelSize * vec2( 1.0,  1.0)).rgb;
+    sum *= 0.25;
+#ifdef BRIGHT_PASS
+    // keep the part of the color above the threshold
+    float brightness = max(sum.r, max(sum.g, sum.b));
+    sum *= max(brightness - threshold, 0.0) / max(brightness, 0.0001);
+#endif
+    color = vec4(sum, 1.0);
+#elif defined(UPSAMPLE)
+    // 3x3 tent filter over the smaller source, added onto the target by the blend state
+    vec3 sum = vec3(0.0);
+    for (int y = -1; y <= 1; y++)
+        for (int x = -1; x <= 1; x++)
+            sum += texture(source, TexCoords + texelSize * vec2(x, y)).rgb * float((2 - abs(x)) * (2 - abs(y)));
+    color = vec4(sum * (intensity / 16.0), 0.0);
+#elif defined(EDGE)
+    vec3 sum = texture(source, TexCoords).rgb * 9.0;
+    for (int y = -1; y <= 1; y++)
+        for (int x = -1; x <= 1; x++)
+            sum -= texture(source, TexCoords + texelSize * vec2(x, y)).rgb;
+    color = vec4(sum, 1.0);
+#elif defined(INVERT)
+    color = vec4(1.0 - texture(source, TexCoords).rgb, 1.0);
+#else
+    color = texture(source, TexCoords);
+#endif
+}
@@ -3,42 +3,81 @@ in  vec2  TexCoords;
 out vec4  color;
 
 uniform sampler2D scene;
-uniform vec2      offsets[9];
-uniform int       edge_kernel[9];
-uniform float     blur_kernel[9];
 
-uniform bool chaos;
-uniform bool confuse;
-uniform bool shake;
+// compiled per effect set: CHAOS (edge detection) wins over CONFUSE (inverted colors);
+// REDUCED_EFFECTS (EFFECTS_REDUCED) cuts chaos down to a 5 tap kernel.
+// SHAKE only moves the quad (post_processing.vs), its blur runs as an effect chain pass before this one.
+// FXAA smooths the edges of a scene rendered without multisampling (ignored by chaos, which only keeps edges)
+#if defined(CHAOS)
+const float offset = 1.0 / 300.0;
+const vec2 offsets[9] = vec2[](
+    vec2(-offset,  offset), vec2(0.0,  offset), vec2(offset,  offset),
+    vec2(-offset,  0.0),    vec2(0.0,  0.0),    vec2(offset,  0.0),
+    vec2(-offset, -offset), vec2(0.0, -offset), vec2(offset, -offset)
+);
+#endif
 
-void main()
+#if defined(FXAA)
+// edges are found from the luma of the 4 diagonal neighbours and blended across along their direction
+const vec3  LUMA = vec3(0.299, 0.587, 0.114);
+const float FXAA_REDUCE_MIN = 1.0 / 128.0;
+const float FXAA_REDUCE_MUL = 1.0 / 8.0;
+const float FXAA_SPAN_MAX = 8.0;
+// contrast below which a pixel is left alone, absolute and relative to the brightest neighbour
+const float FXAA_EDGE_MIN = 1.0 / 32.0;
+const float FXAA_EDGE_RELATIVE = 1.0 / 8.0;
+
+vec4 sceneColor(vec2 uv)
+{
+    vec2 texel = 1.0 / vec2(textureSize(scene, 0));
+    vec4 center = texture(scene, uv);
+    float lumaNW = dot(texture(scene, uv + vec2(-1.0, -1.0) * texel).rgb, LUMA);
+    float lumaNE = dot(texture(scene, uv + vec2( 1.0, -1.0) * texel).rgb, LUMA);
+    float lumaSW = dot(texture(scene, uv + vec2(-1.0,  1.0) * texel).rgb, LUMA);
+    float lumaSE = dot(texture(scene, uv + vec2( 1.0,  1.0) * texel).rgb, LUMA);
+    float lumaM = dot(center.rgb, LUMA);
+    float lumaMin = min(lumaM, min(min(lumaNW, lumaNE), min(lumaSW, lumaSE)));
+    float lumaMax = max(lumaM, max(max(lumaNW, lumaNE), max(lumaSW, lumaSE)));
+    // flat areas, most of a breakout screen, cost just the 5 fetches
+    if (lumaMax - lumaMin < max(FXAA_EDGE_MIN, lumaMax * FXAA_EDGE_RELATIVE))
+        return center;
+    vec2 dir = vec2(-((lumaNW + lumaNE) - (lumaSW + lumaSE)), (lumaNW + lumaSW) - (lumaNE + lumaSE));
+    float dirReduce = max((lumaNW + lumaNE + lumaSW + lumaSE) * 0.25 * FXAA_REDUCE_MUL, FXAA_REDUCE_MIN);
+    float rcpDirMin = 1.0 / (min(abs(dir.x), abs(dir.y)) + dirReduce);
+    dir = clamp(dir * rcpDirMin, -FXAA_SPAN_MAX, FXAA_SPAN_MAX) * texel;
+    // a short blend along the edge, and a longer one unless it overshoots the neighbourhood
+    vec4 near = 0.5 * (texture(scene, uv + dir * (1.0 / 3.0 - 0.5)) + texture(scene, uv + dir * (2.0 / 3.0 - 0.5)));
+    vec4 far = near * 0.5 + 0.25 * (texture(scene, uv - dir * 0.5) + texture(scene, uv + dir * 0.5));
+    float lumaFar = dot(far.rgb, LUMA);
+    return (lumaFar < lumaMin || lumaFar > lumaMax) ? near : far;
+}
+#else
+vec4 sceneColor(vec2 uv)
 {
-    color = vec4(0.0f);
-    vec3 sample[9];
-    // sample from texture offsets if using convolution matrix
-    if(chaos || shake)
-        for(int i = 0; i < 9; i++)
-            sample[i] = vec3(texture(scene, TexCoords.st + offsets[i]));
+    return texture(scene, uv);
+}
+#endif
 
-    // process effects
-    if (chaos)
-    {
-        for(int i = 0; i < 9; i++)
-            color += vec4(sample[i] * edge_kernel[i], 0.0f);
-        color.a = 1.0f;
-    }
-    else if (confuse)
-    {
-        color = vec4(1.0 - texture(scene, TexCoords).rgb, 1.0);
-    }
-    else if (shake)
-    {
-        for(int i = 0; i < 9; i++)
-            color += vec4(sample[i] * blur_kernel[i], 0.0f);
-        color.a = 1.0f;
-    }
-    else
-    {
-        color =  texture(scene, TexCoords);
-    }
-}
\ No newline at end of file
+void main()
+{
+#if defined(CHAOS) && !defined(REDUCED_EFFECTS)
+    const float edge_kernel[9] = float[](
+        -1.0, -1.0, -1.0,
+        -1.0,  8.0, -1.0,
+        -1.0, -1.0, -1.0
+    );
+    vec3 sum = vec3(0.0);
+    for(int i = 0; i < 9; i++)
+        sum += vec3(texture(scene, TexCoords.st + offsets[i])) * edge_kernel[i];
+    color = vec4(sum, 1.0);
+#elif defined(CHAOS)
+    // only the center and its 4 direct neighbours
+    color = vec4(4.0 * vec3(texture(scene, TexCoords.st + offsets[4]))
+                 - vec3(texture(scene, TexCoords.st + offsets[1])) - vec3(texture(scene, TexCoords.st + offsets[3]))
+                 - vec3(texture(scene, TexCoords.st + offsets[5])) - vec3(texture(scene, TexCoords.st + offsets[7])), 1.0);
+#elif defined(CONFUSE)
+    color = vec4(1.0 - sceneColor(TexCoords).rgb, 1.0);
+#else
+    color = sceneColor(TexCoords);
+#endif
+}
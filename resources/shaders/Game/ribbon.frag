@@ -0,0 +1,13 @@
+#version 330 core
+in float Across;
+in float Fade;
+out vec4 color;
+
+uniform vec3 ribbonColor;
+
+void main()
+{
+    // soft edges and a fade towards the end of the trail
+    float edge = 1.0 - abs(Across);
+    color = vec4(ribbonColor * edge * Fade, 0.0); // premultiplied, additive
+}
@@ -0,0 +1,39 @@
+#version 330 core
+// Expands a ribbon trail into a triangle strip without any vertex buffer:
+// vertex 2i and 2i+1 are the two edges of the ribbon at the i-th newest point.
+const int MAX_POINTS = 64; // RIBBON_MAX_POINTS
+
+out float Across; // -1 .. 1 from one edge of the ribbon to the other
+out float Fade;   // 1 at the head, 0 at the end of the trail
+
+layout (std140) uniform FrameData
+{
+    mat4  projection;
+    vec2  viewportSize;
+    float time;
+};
+uniform vec2 points[MAX_POINTS]; // ring of trail positions
+uniform int head;                // index of the newest point in the ring
+uniform int count;               // number of recorded points
+uniform int ringSize;
+uniform float ribbonWidth;
+
+// i-th newest point
+vec2 point(int i)
+{
+    return points[(head - clamp(i, 0, count - 1) + ringSize) % ringSize];
+}
+
+void main()
+{
+    int i = gl_VertexID / 2;
+    Across = (gl_VertexID & 1) == 0 ? -1.0 : 1.0;
+    Fade = 1.0 - float(i) / float(count - 1);
+    // the ribbon runs perpendicular to the trail direction at each point; where the points
+    // coincide (the object stood still) it collapses to nothing
+    vec2 direction = point(i - 1) - point(i + 1);
+    float len = length(direction);
+    vec2 normal = len > 0.0001 ? vec2(-direction.y, direction.x) / len : vec2(0.0);
+    vec2 position = point(i) + normal * Across * 0.5 * ribbonWidth * Fade;
+    gl_Position = projection * vec4(position, 0.0, 1.0);
+}
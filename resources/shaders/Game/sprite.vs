@@ -1,13 +1,31 @@
 #version 330 core
 layout (location = 0) in vec4 vertex; // <vec2 position, vec2 texCoords>
+layout (location = 1) in vec4 instanceRect; // <vec2 position, vec2 size>
+layout (location = 2) in float instanceRotation; // degrees
+layout (location = 3) in vec4 instanceColor; // premultiplied tint, alpha 0 = additive
+layout (location = 4) in vec4 instanceUV; // <vec2 min, vec2 max> texture region, e.g. inside an atlas
 
 out vec2 TexCoords;
+out vec4 SpriteColor;
 
-uniform mat4 model;
-uniform mat4 projection;
+layout (std140) uniform FrameData
+{
+    mat4  projection;
+    vec2  viewportSize;
+    float time;
+};
 
+// sprite attributes 1-4 are per instance (SpriteBatch) or constant vertex attributes (SpriteRenderer)
 void main()
 {
-    TexCoords = vertex.zw;
-    gl_Position = projection * model * vec4(vertex.xy, 0.0, 1.0);
-}
\ No newline at end of file
+    TexCoords = mix(instanceUV.xy, instanceUV.zw, vertex.zw);
+    SpriteColor = instanceColor;
+    // scale the unit quad around its center, rotate, then move it into place
+    vec2 size = instanceRect.zw;
+    vec2 local = (vertex.xy - 0.5) * size;
+    float angle = radians(instanceRotation);
+    float s = sin(angle);
+    float c = cos(angle);
+    local = vec2(c * local.x - s * local.y, s * local.x + c * local.y);
+    gl_Position = projection * vec4(instanceRect.xy + 0.5 * size + local, 0.0, 1.0);
+}
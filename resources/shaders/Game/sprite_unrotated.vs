@@ -0,0 +1,23 @@
+#version 330 core
+layout (location = 0) in vec4 vertex; // <vec2 position, vec2 texCoords>
+layout (location = 1) in vec4 instanceRect; // <vec2 position, vec2 size>
+layout (location = 3) in vec4 instanceColor; // premultiplied tint, alpha 0 = additive
+layout (location = 4) in vec4 instanceUV; // <vec2 min, vec2 max> texture region, e.g. inside an atlas
+
+out vec2 TexCoords;
+out vec4 SpriteColor;
+
+layout (std140) uniform FrameData
+{
+    mat4  projection;
+    vec2  viewportSize;
+    float time;
+};
+
+// variant of sprite.vs for sprites without rotation: the quad only needs to be scaled and moved
+void main()
+{
+    TexCoords = mix(instanceUV.xy, instanceUV.zw, vertex.zw);
+    SpriteColor = instanceColor;
+    gl_Position = projection * vec4(instanceRect.xy + vertex.xy * instanceRect.zw, 0.0, 1.0);
+}
@@ -8,6 +8,7 @@ uniform vec3 textColor;
 
 void main()
 {
-    vec4 sampled = vec4(1.0, 1.0, 1.0, texture(text, TexCoords).r);
-    color = vec4(textColor, 1.0) * sampled;
+    // the glyph coverage is the alpha; output it premultiplied
+    float coverage = texture(text, TexCoords).r;
+    color = vec4(textColor * coverage, coverage);
 }
\ No newline at end of file